@@ -1,6 +1,11 @@
 #pragma once
 
+#include <cstddef>
+#include <functional>
+#include <span>
+
 #include <wand/resource.hpp>
+#include <wand/tlsf_allocator.hpp>
 
 namespace wand {
 struct BufferDesc {
@@ -9,22 +14,72 @@ struct BufferDesc {
   bool constant_buffer;
   bool shader_resource;
   bool unordered_access;
+
+  [[nodiscard]] auto operator==(BufferDesc const& other) const -> bool = default;
 };
 
+namespace details {
+// Resource that buffers with matching CPU access and resource flags are sub-allocated from.
+struct BufferPage {
+  Microsoft::WRL::ComPtr<D3D12MA::Allocation> allocation;
+  Microsoft::WRL::ComPtr<ID3D12Resource2> resource;
+  CpuAccess cpu_access;
+  D3D12_RESOURCE_FLAGS flags;
+  TlsfAllocator allocator;
+  // Mapped once for the lifetime of the page. Null for pages without CPU access.
+  std::byte* mapped_data;
+};
+}
+
+
+// Small buffers may be sub-allocated from a resource shared with other buffers.
+// Commands addressing the internal resource directly have to account for the offset of the buffer.
 class Buffer : public Resource {
 public:
+  // Sub-allocated buffers share their resource with other buffers and ignore the name.
+  auto SetDebugName(std::wstring_view name) const -> void;
   [[nodiscard]]
   auto GetDesc() const -> BufferDesc const&;
   [[nodiscard]]
   auto GetConstantBuffer() const -> UINT;
+  // Offset of the buffer within its internal resource.
+  [[nodiscard]]
+  auto GetOffset() const -> UINT64;
+  [[nodiscard]]
+  auto IsSubAllocated() const -> bool;
+  [[nodiscard]]
+  auto GetGpuVirtualAddress() const -> D3D12_GPU_VIRTUAL_ADDRESS;
+  // Buffers with CPU access stay mapped for their whole lifetime. Empty for buffers without CPU access.
+  [[nodiscard]]
+  auto GetMappedData() const -> std::span<std::byte>;
+  // Returns the persistently mapped pointer for buffers with CPU access. Readback buffers are invalidated as a whole.
+  [[nodiscard]]
+  auto Map() const -> void*;
+  auto Unmap() const -> void;
+  // Makes CPU writes to the range visible to the GPU.
+  auto FlushRange(UINT64 offset, UINT64 size) const -> void;
+  // Makes GPU writes to the range visible to the CPU.
+  auto InvalidateRange(UINT64 offset, UINT64 size) const -> void;
 
 private:
   Buffer(Microsoft::WRL::ComPtr<D3D12MA::Allocation> allocation, Microsoft::WRL::ComPtr<ID3D12Resource2> resource,
-         std::optional<UINT> cbv, std::optional<UINT> srv, std::optional<UINT> uav, BufferDesc const& desc);
+         std::optional<UINT> cbv, std::optional<UINT> srv, std::optional<UINT> uav, BufferDesc const& desc,
+         CpuAccess cpu_access, UINT64 offset, details::BufferPage* page);
 
   BufferDesc desc_;
   std::optional<UINT> cbv_;
+  CpuAccess cpu_access_;
+  std::span<std::byte> mapped_data_;
+  UINT64 offset_;
+  // The page the buffer is sub-allocated from, if any.
+  details::BufferPage* page_;
 
   friend GraphicsDevice;
 };
 }
+
+
+template<>
+struct std::hash<wand::BufferDesc> {
+  [[nodiscard]] auto operator()(wand::BufferDesc const& desc) const noexcept -> std::size_t;
+};
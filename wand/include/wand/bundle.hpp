@@ -0,0 +1,107 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include <wand/buffer.hpp>
+#include <wand/command_signature_cache.hpp>
+#include <wand/descriptor_heap.hpp>
+#include <wand/pipeline.hpp>
+#include <wand/root_signature_cache.hpp>
+#include <wand/texture.hpp>
+
+namespace wand {
+namespace details {
+struct BufferUsage {
+  Buffer const* buffer;
+  D3D12_BARRIER_SYNC sync;
+  D3D12_BARRIER_ACCESS access;
+};
+
+
+struct TextureUsage {
+  Texture const* texture;
+  D3D12_BARRIER_SYNC sync;
+  D3D12_BARRIER_ACCESS access;
+  D3D12_BARRIER_LAYOUT layout;
+};
+}
+
+
+// Prerecorded draw and bind commands replayed through CommandList::ExecuteBundle. Bundles cannot contain barriers, so
+// their resource usages are merged into the executing command list instead. Used resources must outlive the bundle.
+class Bundle {
+public:
+  Bundle(Bundle const&) = delete;
+  Bundle(Bundle&&) = delete;
+
+  ~Bundle();
+
+  auto operator=(Bundle const&) -> void = delete;
+  auto operator=(Bundle&&) -> void = delete;
+
+  auto Begin(PipelineState const* pipeline_state) -> void;
+  auto End() const -> void;
+  auto Dispatch(UINT thread_group_count_x, UINT thread_group_count_y,
+                UINT thread_group_count_z) const -> void;
+  auto DispatchIndirect(Buffer const& arg_buf, UINT64 arg_offset, UINT max_command_count,
+                        Buffer const* count_buf = nullptr, UINT64 count_offset = 0) -> void;
+  auto DispatchMesh(UINT thread_group_count_x, UINT thread_group_count_y,
+                    UINT thread_group_count_z) const -> void;
+  auto DispatchMeshIndirect(Buffer const& arg_buf, UINT64 arg_offset, UINT max_command_count,
+                            Buffer const* count_buf = nullptr, UINT64 count_offset = 0) -> void;
+  auto DrawIndexedIndirect(Buffer const& arg_buf, UINT64 arg_offset, UINT max_command_count,
+                           Buffer const* count_buf = nullptr, UINT64 count_offset = 0) -> void;
+  auto DrawIndexedInstanced(UINT index_count_per_instance, UINT instance_count, UINT start_index_location,
+                            INT base_vertex_location, UINT start_instance_location) const -> void;
+  auto DrawIndirect(Buffer const& arg_buf, UINT64 arg_offset, UINT max_command_count,
+                    Buffer const* count_buf = nullptr, UINT64 count_offset = 0) -> void;
+  auto DrawInstanced(UINT vertex_count_per_instance, UINT instance_count, UINT start_vertex_location,
+                     UINT start_instance_location) const -> void;
+  auto SetBlendFactor(std::span<FLOAT const, 4> blend_factor) const -> void;
+  auto SetIndexBuffer(Buffer const& buf, DXGI_FORMAT index_format) -> void;
+  auto SetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY primitive_topology) const -> void;
+  auto SetStencilRef(UINT stencil_ref) const -> void;
+  auto SetPipelineParameter(UINT index, UINT value) const -> void;
+  auto SetPipelineParameters(UINT index, std::span<UINT const> values) const -> void;
+  auto SetConstantBuffer(UINT param_idx, Buffer const& buf) -> void;
+  auto SetShaderResource(UINT param_idx, Buffer const& buf) -> void;
+  auto SetShaderResource(UINT param_idx, Texture const& tex) -> void;
+  auto SetUnorderedAccess(UINT param_idx, Buffer const& buf) -> void;
+  auto SetUnorderedAccess(UINT param_idx, Texture const& tex) -> void;
+  auto SetPipelineState(PipelineState const& pipeline_state) -> void;
+
+private:
+  auto SetRootSignature(std::uint8_t num_params) const -> void;
+
+  Bundle(Microsoft::WRL::ComPtr<ID3D12CommandAllocator> allocator,
+         Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList7> cmd_list, details::DescriptorHeap const* res_desc_heap,
+         details::DescriptorHeap const* sampler_heap, details::RootSignatureCache* root_signatures,
+         details::CommandSignatureCache* command_signatures);
+
+  auto ExecuteIndirect(IndirectCommandType type, Buffer const& arg_buf, UINT64 arg_offset, UINT max_command_count,
+                       Buffer const* count_buf, UINT64 count_offset) -> void;
+
+  auto DeclareUsage(Buffer const& buf, D3D12_BARRIER_SYNC sync, D3D12_BARRIER_ACCESS access) -> void;
+  auto DeclareUsage(Texture const& tex, D3D12_BARRIER_SYNC sync, D3D12_BARRIER_ACCESS access,
+                    D3D12_BARRIER_LAYOUT layout) -> void;
+  auto ClearUsages() -> void;
+
+  Microsoft::WRL::ComPtr<ID3D12CommandAllocator> allocator_;
+  Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList7> cmd_list_;
+  std::vector<details::BufferUsage> buffer_usages_;
+  std::vector<details::TextureUsage> texture_usages_;
+  details::DescriptorHeap const* res_desc_heap_;
+  details::DescriptorHeap const* sampler_heap_;
+  details::RootSignatureCache* root_signatures_;
+  details::CommandSignatureCache* command_signatures_;
+  std::uint8_t num_params_{0};
+  bool compute_pipeline_set_{false};
+  // The pipeline state and root signature set last stay bound in the executing command list.
+  bool pipeline_set_{false};
+  bool pipeline_allows_ds_write_{false};
+
+  friend GraphicsDevice;
+  friend class CommandList;
+};
+}
@@ -3,11 +3,15 @@
 #include <span>
 
 #include <wand/buffer.hpp>
+#include <wand/bundle.hpp>
+#include <wand/command_signature_cache.hpp>
 #include <wand/descriptor_heap.hpp>
 #include <wand/pipeline.hpp>
+#include <wand/queue.hpp>
 #include <wand/resource_state_tracker.hpp>
 #include <wand/root_signature_cache.hpp>
 #include <wand/texture.hpp>
+#include <wand/transient_resource_heap.hpp>
 
 namespace wand {
 namespace details {
@@ -34,16 +38,28 @@ public:
                          Texture const& src, UINT src_subresource_index, D3D12_BOX const* src_box) -> void;
   auto CopyTextureRegion(Texture const& dst, UINT dst_subresource_index, UINT dst_x, UINT dst_y, UINT dst_z,
                          Buffer const& src, D3D12_PLACED_SUBRESOURCE_FOOTPRINT const& src_footprint) -> void;
+  auto CopyTextureRegion(Buffer const& dst, D3D12_PLACED_SUBRESOURCE_FOOTPRINT const& dst_footprint,
+                         Texture const& src, UINT src_subresource_index, D3D12_BOX const* src_box) -> void;
   auto DiscardRenderTarget(Texture const& tex, std::optional<D3D12_DISCARD_REGION> const& region) -> void;
   auto DiscardDepthStencil(Texture const& tex, std::optional<D3D12_DISCARD_REGION> const& region) -> void;
   auto Dispatch(UINT thread_group_count_x, UINT thread_group_count_y,
                 UINT thread_group_count_z) const -> void;
+  auto DispatchIndirect(Buffer const& arg_buf, UINT64 arg_offset, UINT max_command_count,
+                        Buffer const* count_buf = nullptr, UINT64 count_offset = 0) -> void;
   auto DispatchMesh(UINT thread_group_count_x, UINT thread_group_count_y,
                     UINT thread_group_count_z) const -> void;
+  auto DispatchMeshIndirect(Buffer const& arg_buf, UINT64 arg_offset, UINT max_command_count,
+                            Buffer const* count_buf = nullptr, UINT64 count_offset = 0) -> void;
+  auto DrawIndexedIndirect(Buffer const& arg_buf, UINT64 arg_offset, UINT max_command_count,
+                           Buffer const* count_buf = nullptr, UINT64 count_offset = 0) -> void;
   auto DrawIndexedInstanced(UINT index_count_per_instance, UINT instance_count, UINT start_index_location,
                             INT base_vertex_location, UINT start_instance_location) const -> void;
+  auto DrawIndirect(Buffer const& arg_buf, UINT64 arg_offset, UINT max_command_count,
+                    Buffer const* count_buf = nullptr, UINT64 count_offset = 0) -> void;
   auto DrawInstanced(UINT vertex_count_per_instance, UINT instance_count, UINT start_vertex_location,
                      UINT start_instance_location) const -> void;
+  // Graphics command lists only. The pipeline state and root signature the bundle set last stay bound afterwards.
+  auto ExecuteBundle(Bundle const& bundle) -> void;
   auto Resolve(Texture const& dst, Texture const& src, DXGI_FORMAT format) -> void;
   auto SetBlendFactor(std::span<FLOAT const, 4> blend_factor) const -> void;
   auto SetIndexBuffer(Buffer const& buf, DXGI_FORMAT index_format) -> void;
@@ -60,7 +76,16 @@ public:
   auto SetShaderResource(UINT param_idx, Texture const& tex) -> void;
   auto SetUnorderedAccess(UINT param_idx, Buffer const& buf) -> void;
   auto SetUnorderedAccess(UINT param_idx, Texture const& tex) -> void;
+  // Binds the fallback of pipeline states still compiling. Draws and dispatches are skipped while neither is ready.
   auto SetPipelineState(PipelineState const& pipeline_state) -> void;
+  // Begins the lifetimes of the transient resources first used in the pass, discarding their previous contents.
+  auto BeginTransientPass(TransientResourceHeap const& heap, UINT pass) -> void;
+  // Declares resources that shaders only reach through descriptor indices so that their memory is made resident before
+  // the submission executes. Resources bound or used by commands are tracked automatically.
+  auto UseResource(Buffer const& buf) -> void;
+  auto UseResource(Texture const& tex) -> void;
+
+  [[nodiscard]] auto GetQueueType() const -> QueueType;
 
 private:
   auto SetRootSignature(std::uint8_t num_params) const -> void;
@@ -68,23 +93,33 @@ private:
   CommandList(Microsoft::WRL::ComPtr<ID3D12CommandAllocator> allocator,
               Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList7> cmd_list, details::DescriptorHeap const* dsv_heap,
               details::DescriptorHeap const* rtv_heap, details::DescriptorHeap const* res_desc_heap,
-              details::DescriptorHeap const* sampler_heap, details::RootSignatureCache* root_signatures);
+              details::DescriptorHeap const* sampler_heap, details::RootSignatureCache* root_signatures,
+              details::CommandSignatureCache* command_signatures, QueueType queue_type);
+
+  auto ExecuteIndirect(IndirectCommandType type, Buffer const& arg_buf, UINT64 arg_offset, UINT max_command_count,
+                       Buffer const* count_buf, UINT64 count_offset) -> void;
 
   auto GenerateBarrier(Buffer const& buf, D3D12_BARRIER_SYNC sync, D3D12_BARRIER_ACCESS access) -> void;
+  // Layouts are specified as direct queue layouts and are converted to the queue type of the command list.
   auto GenerateBarrier(Texture const& tex, D3D12_BARRIER_SYNC sync, D3D12_BARRIER_ACCESS access,
-                       D3D12_BARRIER_LAYOUT layout) -> void;
+                       D3D12_BARRIER_LAYOUT direct_queue_layout) -> void;
 
   Microsoft::WRL::ComPtr<ID3D12CommandAllocator> allocator_;
   Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList7> cmd_list_;
   details::PipelineResourceStateTracker local_resource_states_;
   std::vector<details::PendingBarrier> pending_barriers_;
+  std::vector<ID3D12Resource*> used_resources_;
   details::DescriptorHeap const* dsv_heap_;
   details::DescriptorHeap const* rtv_heap_;
   details::DescriptorHeap const* res_desc_heap_;
   details::DescriptorHeap const* sampler_heap_;
   details::RootSignatureCache* root_signatures_;
+  details::CommandSignatureCache* command_signatures_;
+  QueueType queue_type_;
+  std::uint8_t num_params_{0};
   bool compute_pipeline_set_{false};
   bool pipeline_allows_ds_write_{false};
+  bool skip_draws_{false};
 
   friend GraphicsDevice;
 };
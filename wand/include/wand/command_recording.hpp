@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include <wand/buffer.hpp>
+#include <wand/command_signature_cache.hpp>
+#include <wand/descriptor_heap.hpp>
+#include <wand/root_signature_cache.hpp>
+
+namespace wand::details {
+// Recording shared by command lists and bundles. Resource usages are left to the callers, command lists generate
+// barriers for them while bundles declare them to the executing command list.
+auto RecordDescriptorHeaps(ID3D12GraphicsCommandList7& cmd_list, DescriptorHeap const& res_desc_heap,
+                           DescriptorHeap const& sampler_heap) -> void;
+auto RecordRootSignature(ID3D12GraphicsCommandList7& cmd_list, RootSignatureCache& root_signatures,
+                         std::uint8_t num_params, bool compute) -> void;
+auto RecordPipelineParameters(ID3D12GraphicsCommandList7& cmd_list, UINT index, std::span<UINT const> values,
+                              bool compute) -> void;
+auto RecordIndexBuffer(ID3D12GraphicsCommandList7& cmd_list, Buffer const& buf, DXGI_FORMAT index_format) -> void;
+auto RecordDrawIndexedInstanced(ID3D12GraphicsCommandList7& cmd_list, UINT index_count_per_instance,
+                                UINT instance_count, UINT start_index_location, INT base_vertex_location,
+                                UINT start_instance_location) -> void;
+auto RecordDrawInstanced(ID3D12GraphicsCommandList7& cmd_list, UINT vertex_count_per_instance, UINT instance_count,
+                         UINT start_vertex_location, UINT start_instance_location) -> void;
+// Throws if there is no command signature for the command type and parameter count.
+auto RecordExecuteIndirect(ID3D12GraphicsCommandList7& cmd_list, CommandSignatureCache& command_signatures,
+                           std::uint8_t num_params, IndirectCommandType type, Buffer const& arg_buf,
+                           UINT64 arg_offset, UINT max_command_count, Buffer const* count_buf,
+                           UINT64 count_offset) -> void;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <utility>
+
+#include <wand/indirect_command.hpp>
+#include <wand/platforms/d3d12.hpp>
+
+namespace wand::details {
+class CommandSignatureCache {
+public:
+  auto Add(std::uint8_t num_params, IndirectCommandType type,
+           Microsoft::WRL::ComPtr<ID3D12CommandSignature> command_signature) -> Microsoft::WRL::ComPtr<
+    ID3D12CommandSignature>;
+  [[nodiscard]] auto Get(std::uint8_t num_params,
+                         IndirectCommandType type) -> Microsoft::WRL::ComPtr<ID3D12CommandSignature>;
+
+private:
+  std::map<std::pair<std::uint8_t, IndirectCommandType>, Microsoft::WRL::ComPtr<ID3D12CommandSignature>>
+  command_signatures_;
+  std::mutex mutex_;
+};
+}
@@ -10,15 +10,31 @@ class Buffer;
 class Texture;
 class PipelineState;
 class CommandList;
+class Bundle;
 class Fence;
 class SwapChain;
+class UploadRing;
+class MemoryPool;
+class TransientResourceHeap;
+class TilePool;
+class GeometryPool;
+class UploadQueue;
+class ResourcePool;
 
 template<typename T>concept DeviceChild = std::same_as<std::remove_const_t<T>, Buffer> || std::same_as<
   std::remove_const_t<T>, Texture> || std::same_as<
   std::remove_const_t<T>, PipelineState> || std::same_as<
   std::remove_const_t<T>, CommandList> || std::same_as<
+  std::remove_const_t<T>, Bundle> || std::same_as<
   std::remove_const_t<T>, Fence> || std::same_as<
-  std::remove_const_t<T>, SwapChain>;
+  std::remove_const_t<T>, SwapChain> || std::same_as<
+  std::remove_const_t<T>, UploadRing> || std::same_as<
+  std::remove_const_t<T>, MemoryPool> || std::same_as<
+  std::remove_const_t<T>, TransientResourceHeap> || std::same_as<
+  std::remove_const_t<T>, TilePool> || std::same_as<
+  std::remove_const_t<T>, GeometryPool> || std::same_as<
+  std::remove_const_t<T>, UploadQueue> || std::same_as<
+  std::remove_const_t<T>, ResourcePool>;
 
 template<DeviceChild T>
 class DeviceChildDeleter;
@@ -46,6 +62,14 @@ extern template class DeviceChildDeleter<Buffer>;
 extern template class DeviceChildDeleter<Texture>;
 extern template class DeviceChildDeleter<PipelineState>;
 extern template class DeviceChildDeleter<CommandList>;
+extern template class DeviceChildDeleter<Bundle>;
 extern template class DeviceChildDeleter<Fence>;
 extern template class DeviceChildDeleter<SwapChain>;
+extern template class DeviceChildDeleter<UploadRing>;
+extern template class DeviceChildDeleter<MemoryPool>;
+extern template class DeviceChildDeleter<TransientResourceHeap>;
+extern template class DeviceChildDeleter<TilePool>;
+extern template class DeviceChildDeleter<GeometryPool>;
+extern template class DeviceChildDeleter<UploadQueue>;
+extern template class DeviceChildDeleter<ResourcePool>;
 }
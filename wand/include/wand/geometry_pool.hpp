@@ -0,0 +1,52 @@
+#pragma once
+
+#include <mutex>
+#include <optional>
+
+#include <wand/buffer.hpp>
+#include <wand/command_list.hpp>
+#include <wand/device_child.hpp>
+#include <wand/tlsf_allocator.hpp>
+
+namespace wand {
+struct GeometryPoolDesc {
+  UINT64 size;
+  // Allows compute shaders to write geometry in place.
+  bool unordered_access;
+};
+
+
+struct GeometryAllocation {
+  // Byte offset into the buffer of the pool, stable for the lifetime of the allocation.
+  UINT64 offset;
+  UINT64 size;
+};
+
+
+// Single raw buffer that geometry of many meshes is sub-allocated from. Shaders address meshes by byte offset through
+// the shader resource view of the pool instead of through a descriptor for each mesh.
+class GeometryPool {
+public:
+  // Returns nothing if the pool has no free range large enough.
+  [[nodiscard]] auto Allocate(UINT64 size, UINT64 alignment = 4) -> std::optional<GeometryAllocation>;
+  // The GPU must be done with the range.
+  auto Free(GeometryAllocation const& allocation) -> void;
+  // Declares the pool used by the command list. Shaders only reach the geometry through the views of the pool, so this
+  // is required to keep the memory of the pool resident while the command list executes.
+  auto Use(CommandList& cmd_list) const -> void;
+
+  [[nodiscard]] auto GetBuffer() const -> Buffer const&;
+  [[nodiscard]] auto GetShaderResource() const -> UINT;
+  [[nodiscard]] auto GetUnorderedAccess() const -> UINT;
+  [[nodiscard]] auto GetFreeSize() const -> UINT64;
+
+private:
+  explicit GeometryPool(SharedDeviceChildHandle<Buffer> buffer);
+
+  SharedDeviceChildHandle<Buffer> buffer_;
+  details::TlsfAllocator allocator_;
+  mutable std::mutex mutex_;
+
+  friend GraphicsDevice;
+};
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+#include <wand/platforms/d3d12.hpp>
+
+namespace wand {
+enum class IndirectCommandType : std::uint8_t {
+  kDraw,
+  kDrawIndexed,
+  kDispatch,
+  kDispatchMesh
+};
+
+
+// Each command starts with the pipeline parameters of the bound pipeline state, followed by the base vertex and base
+// instance for draws, followed by the matching D3D12_*_ARGUMENTS struct.
+[[nodiscard]] auto GetIndirectCommandStride(IndirectCommandType type, std::uint8_t num_params) -> UINT;
+}
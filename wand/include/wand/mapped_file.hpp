@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+#include <wand/platforms/d3d12.hpp>
+
+namespace wand::details {
+// Read-only view of a whole file mapped into the address space.
+class MappedFile {
+public:
+  explicit MappedFile(std::filesystem::path const& path);
+  MappedFile(MappedFile const&) = delete;
+  MappedFile(MappedFile&&) = delete;
+
+  ~MappedFile();
+
+  auto operator=(MappedFile const&) -> void = delete;
+  auto operator=(MappedFile&&) -> void = delete;
+
+  [[nodiscard]] auto GetData() const -> std::span<std::byte const>;
+
+private:
+  HANDLE file_{INVALID_HANDLE_VALUE};
+  HANDLE mapping_{nullptr};
+  void const* view_{nullptr};
+  std::size_t size_{0};
+};
+}
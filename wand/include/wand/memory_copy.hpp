@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstddef>
+
+namespace wand::details {
+// Copies using non-temporal stores that bypass the CPU caches. Meant for writing into write-combined upload memory.
+auto StreamingCopy(void* dst, void const* src, std::size_t size) -> void;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <wand/resource.hpp>
+
+namespace wand {
+struct MemoryPoolDesc {
+  CpuAccess cpu_access;
+  // Must restrict the pool to a single resource category on devices with resource heap tier 1.
+  D3D12_HEAP_FLAGS heap_flags;
+  // Zero selects the default block size.
+  UINT64 block_size;
+  UINT min_block_count;
+  // Zero means unlimited. Allocations fail once the pool would exceed it.
+  UINT max_block_count;
+  // Allocates linearly within the blocks, suited for transient resources freed in allocation order.
+  bool linear;
+};
+
+
+// Dedicated set of memory blocks resources can be allocated from to cap and isolate their memory usage.
+// The pool must outlive the resources allocated from it.
+class MemoryPool {
+public:
+  [[nodiscard]] auto GetDesc() const -> MemoryPoolDesc const&;
+  // Returns the number of bytes allocated from the pool and the number of bytes in its memory blocks.
+  auto GetUsage(UINT64& allocation_bytes, UINT64& block_bytes) const -> void;
+  auto SetDebugName(std::wstring_view name) const -> void;
+
+private:
+  MemoryPool(Microsoft::WRL::ComPtr<D3D12MA::Pool> pool, MemoryPoolDesc const& desc);
+
+  Microsoft::WRL::ComPtr<D3D12MA::Pool> pool_;
+  MemoryPoolDesc desc_;
+
+  friend GraphicsDevice;
+};
+}
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include <wand/device_child.hpp>
 #include <wand/platforms/d3d12.hpp>
 
 namespace wand {
@@ -25,18 +30,44 @@ struct PipelineDesc {
 };
 
 
+namespace details {
+enum class PipelineStateStatus : std::uint8_t {
+  kCompiling,
+  kReady,
+  kFailed
+};
+}
+
+
+// Pipeline states created asynchronously are compiled on worker threads. Until they are ready, command lists bind
+// their fallbacks instead, or skip draws and dispatches if there is no compiled fallback.
 class PipelineState {
+public:
+  [[nodiscard]] auto IsReady() const -> bool;
+  // Blocks until compilation finishes. Throws if it failed.
+  auto Wait() const -> void;
+
+private:
   PipelineState(Microsoft::WRL::ComPtr<ID3D12RootSignature> root_signature,
-                Microsoft::WRL::ComPtr<ID3D12PipelineState> pipeline_state, std::uint8_t num_params, bool is_compute,
+                Microsoft::WRL::ComPtr<ID3D12PipelineState> pipeline_state,
+                SharedDeviceChildHandle<PipelineState> fallback, std::uint8_t num_params, bool is_compute,
                 bool allows_ds_write);
 
+  // Returns the pipeline to bind: this one if compiled, otherwise that of the fallback chain, or null.
+  [[nodiscard]] auto GetReadyPipeline() const -> ID3D12PipelineState*;
+
   Microsoft::WRL::ComPtr<ID3D12RootSignature> root_signature_;
+  // Written by the compiling thread before the status becomes ready.
   Microsoft::WRL::ComPtr<ID3D12PipelineState> pipeline_state_;
+  SharedDeviceChildHandle<PipelineState> fallback_;
   std::uint8_t num_params_;
   bool is_compute_;
   bool allows_ds_write_;
+  std::atomic<details::PipelineStateStatus> status_;
+  std::string error_;
 
   friend class GraphicsDevice;
   friend class CommandList;
+  friend class Bundle;
 };
 }
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <wand/mapped_file.hpp>
+#include <wand/pipeline.hpp>
+#include <wand/platforms/d3d12.hpp>
+
+namespace wand::details {
+// Identifies the adapter and driver a serialized pipeline library was created with.
+struct PipelineLibraryHeader {
+  std::uint32_t magic;
+  std::uint32_t version;
+  UINT vendor_id;
+  UINT device_id;
+  UINT sub_sys_id;
+  UINT revision;
+  std::int64_t driver_version;
+  UINT64 blob_size;
+};
+
+
+// Pipeline states stored by name, persisted to a file that is memory mapped on load.
+class PipelineLibrary {
+public:
+  // Starts out empty if the file is missing or was written for a different adapter or driver.
+  PipelineLibrary(ID3D12Device1& device, IDXGIAdapter4& adapter, std::filesystem::path path);
+
+  // Returns null if the pipeline is not in the library or the library is unsupported.
+  [[nodiscard]] auto Load(std::wstring const& name,
+                          D3D12_PIPELINE_STATE_STREAM_DESC const& desc) -> Microsoft::WRL::ComPtr<ID3D12PipelineState>;
+  auto Store(std::wstring const& name, ID3D12PipelineState& pipeline_state) -> void;
+  // Writes the library to the file if pipelines were stored since it was loaded or last saved.
+  auto Save() -> void;
+
+private:
+  static std::uint32_t const magic_;
+  static std::uint32_t const version_;
+
+  [[nodiscard]] auto CreateLibrary(std::span<std::byte const> blob) -> HRESULT;
+
+  ID3D12Device1* device_;
+  std::filesystem::path path_;
+  PipelineLibraryHeader header_;
+  // The library reads from the serialized data it was created from for its whole lifetime.
+  std::unique_ptr<MappedFile> file_;
+  std::vector<std::byte> blob_;
+  Microsoft::WRL::ComPtr<ID3D12PipelineLibrary1> library_;
+  bool dirty_{false};
+  std::mutex mutex_;
+};
+
+
+// Stable across runs. Covers the contents of the shaders and the root signature the parameter count selects.
+[[nodiscard]] auto HashPipelineDesc(PipelineDesc const& desc, std::uint8_t num_32_bit_params) -> UINT64;
+}
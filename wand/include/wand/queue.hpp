@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <wand/platforms/d3d12.hpp>
+
+namespace wand {
+enum class QueueType : std::uint8_t {
+  kGraphics = 0,
+  kCompute = 1,
+  kCopy = 2
+};
+
+
+auto constexpr kQueueTypeCount{static_cast<std::size_t>(3)};
+
+
+enum class SubmitMode : std::uint8_t {
+  // Command lists are submitted to the queue as soon as they are executed.
+  kImmediate = 0,
+  // Command lists are collected and submitted to their queues together on the next flush.
+  kDeferred = 1
+};
+
+
+namespace details {
+[[nodiscard]] auto AsD3d12CommandListType(QueueType queue_type) -> D3D12_COMMAND_LIST_TYPE;
+// Convert a direct queue specific layout to the equivalent layout specific to the queue type.
+[[nodiscard]] auto MakeQueueSpecificLayout(D3D12_BARRIER_LAYOUT direct_queue_layout,
+                                           QueueType queue_type) -> D3D12_BARRIER_LAYOUT;
+// Returns whether a queue of the specified type can transition a texture from or to the layout.
+[[nodiscard]] auto IsLayoutSupportedOnQueue(D3D12_BARRIER_LAYOUT layout, QueueType queue_type) -> bool;
+}
+}
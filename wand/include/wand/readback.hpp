@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+#include <wand/buffer.hpp>
+#include <wand/device_child.hpp>
+#include <wand/fence.hpp>
+
+namespace wand {
+// Data copied back from the GPU. The staging memory returns to the pool of the device when the handle is destroyed.
+class Readback {
+public:
+  [[nodiscard]] auto IsReady() const -> bool;
+  // Flushes the copy queue if the copy is still waiting for a deferred flush.
+  auto Wait() const -> void;
+  // Throws if the readback is not ready yet.
+  [[nodiscard]] auto GetData() const -> std::span<std::byte const>;
+  // Layout of the data. Buffer readbacks are described as a single row.
+  [[nodiscard]] auto GetFootprint() const -> D3D12_PLACED_SUBRESOURCE_FOOTPRINT const&;
+
+private:
+  Readback(GraphicsDevice& device, SharedDeviceChildHandle<Buffer> staging_buffer, UINT64 size,
+           SharedDeviceChildHandle<Fence const> fence, UINT64 completion_val,
+           D3D12_PLACED_SUBRESOURCE_FOOTPRINT const& footprint);
+
+  GraphicsDevice* device_;
+  SharedDeviceChildHandle<Buffer> staging_buffer_;
+  UINT64 size_;
+  SharedDeviceChildHandle<Fence const> fence_;
+  UINT64 completion_val_;
+  D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprint_;
+
+  friend GraphicsDevice;
+};
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <list>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include <wand/queue.hpp>
+#include <wand/platforms/d3d12.hpp>
+
+namespace wand::details {
+// Tracks the pageable objects resources live in and the submissions that last used them, in least recently used order.
+class ResidencyManager {
+public:
+  // Several resources may live in the same object. Objects are tracked while resources or pins reference them.
+  auto Register(ID3D12Resource* resource, ID3D12Pageable* pageable, UINT64 size) -> void;
+  // Returns the object if it stops being tracked while evicted. New resources may be placed in it later, so it has to
+  // be made resident again.
+  [[nodiscard]] auto Unregister(ID3D12Resource* resource) -> ID3D12Pageable*;
+  // Pinned objects are never evicted.
+  auto Pin(ID3D12Pageable* pageable, UINT64 size) -> void;
+  // Returns the object under the same conditions as Unregister.
+  [[nodiscard]] auto Unpin(ID3D12Pageable* pageable) -> ID3D12Pageable*;
+
+  // Appends the object of the resource to the list if it has to be made resident before the submission.
+  auto MarkUsed(ID3D12Resource* resource, QueueType queue_type, UINT64 fence_val,
+                std::vector<ID3D12Pageable*>& to_make_resident) -> void;
+  // Considers the least recently used objects whose uses completed evicted, until their sizes reach the bytes.
+  [[nodiscard]] auto Trim(UINT64 bytes, std::span<UINT64 const, kQueueTypeCount> completed_fence_vals) ->
+    std::vector<ID3D12Pageable*>;
+
+private:
+  struct TrackedObject {
+    UINT64 size;
+    std::array<UINT64, kQueueTypeCount> last_used_fence_vals{};
+    UINT resource_count{0};
+    UINT pin_count{0};
+    bool resident{true};
+    // Position in the least recently used list while resident.
+    std::list<ID3D12Pageable*>::iterator lru_it;
+  };
+
+  [[nodiscard]] auto Acquire(ID3D12Pageable* pageable, UINT64 size) -> TrackedObject&;
+  // Returns the object if it was released while evicted.
+  [[nodiscard]] auto ReleaseIfUnreferenced(ID3D12Pageable* pageable, TrackedObject const& object) -> ID3D12Pageable*;
+
+  std::unordered_map<ID3D12Resource*, ID3D12Pageable*> resource_objects_;
+  std::unordered_map<ID3D12Pageable*, TrackedObject> objects_;
+  // Resident objects, most recently used first.
+  std::list<ID3D12Pageable*> lru_;
+  std::mutex mutex_;
+};
+}
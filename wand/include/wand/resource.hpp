@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <optional>
 #include <string_view>
 
@@ -8,6 +10,14 @@
 namespace wand {
 class GraphicsDevice;
 
+
+enum class CpuAccess : std::uint8_t {
+  kNone = 0,
+  kRead = 1,
+  kWrite = 2
+};
+
+
 class Resource {
 public:
   auto SetDebugName(std::wstring_view name) const -> void;
@@ -35,6 +45,10 @@ private:
   std::optional<UINT> srv_;
   std::optional<UINT> uav_;
 
+  // Number of usages recorded into bundles. Bundles embed the resource, so it can't be moved by defragmentation.
+  mutable std::atomic<UINT> bundle_usage_count_{0};
+
   friend GraphicsDevice;
+  friend class Bundle;
 };
 }
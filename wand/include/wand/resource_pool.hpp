@@ -0,0 +1,60 @@
+#pragma once
+
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+#include <wand/buffer.hpp>
+#include <wand/device_child.hpp>
+#include <wand/texture.hpp>
+
+namespace wand {
+struct ResourcePoolDesc {
+  // Number of frames the GPU may still access resources for after they are released. Resources are neither handed out
+  // again nor destroyed until that many frames passed.
+  UINT frames_in_flight;
+  // Number of frames released resources are retained for. Must not be less than the frames in flight.
+  UINT retention_frame_count;
+};
+
+
+namespace details {
+template<typename T>
+struct PooledResource {
+  SharedDeviceChildHandle<T> resource;
+  CpuAccess cpu_access;
+  std::optional<D3D12_CLEAR_VALUE> clear_value;
+  // Last frame the resource was referenced outside the pool, and possibly accessed by the GPU.
+  UINT64 last_used_frame;
+};
+}
+
+
+// Retains released resources together with their views and hands them back on requests with matching descriptions.
+// Resources count as released once the pool holds the only handle to them, and are reused once the frames in flight
+// that could still access them have passed. Reused resources keep their previous contents.
+class ResourcePool {
+public:
+  [[nodiscard]] auto AcquireBuffer(BufferDesc const& desc, CpuAccess cpu_access) -> SharedDeviceChildHandle<Buffer>;
+  [[nodiscard]] auto AcquireTexture(TextureDesc const& desc, CpuAccess cpu_access,
+                                    D3D12_CLEAR_VALUE const* clear_value) -> SharedDeviceChildHandle<Texture>;
+  // Advances the frame and destroys the resources released for longer than the retention period.
+  auto NextFrame() -> void;
+  // Destroys every released resource the GPU is done with.
+  auto Trim() -> void;
+
+  [[nodiscard]] auto GetResourceCount() const -> std::size_t;
+
+private:
+  ResourcePool(GraphicsDevice& device, ResourcePoolDesc const& desc);
+
+  GraphicsDevice* device_;
+  ResourcePoolDesc desc_;
+  std::unordered_multimap<BufferDesc, details::PooledResource<Buffer>> buffers_;
+  std::unordered_multimap<TextureDesc, details::PooledResource<Texture>> textures_;
+  UINT64 frame_idx_{0};
+  mutable std::mutex mutex_;
+
+  friend GraphicsDevice;
+};
+}
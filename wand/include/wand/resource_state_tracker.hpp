@@ -3,6 +3,7 @@
 #include <optional>
 #include <unordered_map>
 
+#include <wand/queue.hpp>
 #include <wand/platforms/d3d12.hpp>
 
 namespace wand::details {
@@ -10,6 +11,7 @@ template<typename ResourceStateType>
 class ResourceStateTracker {
 public:
   auto Record(ID3D12Resource* const resource, ResourceStateType const state) -> void;
+  auto Erase(ID3D12Resource* const resource) -> void;
 
   [[nodiscard]] auto Get(ID3D12Resource* const resource) const -> std::optional<ResourceStateType>;
   auto Clear() -> void;
@@ -24,6 +26,10 @@ private:
 
 struct GlobalResourceState {
   D3D12_BARRIER_LAYOUT layout{D3D12_BARRIER_LAYOUT_UNDEFINED};
+  // The queue that last accessed the resource, if any.
+  std::optional<QueueType> queue;
+  // The value the fence of the queue reaches once the last access completes.
+  UINT64 queue_fence_val{0};
 };
 
 
@@ -11,6 +11,11 @@ auto ResourceStateTracker<ResourceStateType>::Record(ID3D12Resource* const resou
   resource_states_[resource] = state;
 }
 
+template<typename ResourceStateType>
+auto ResourceStateTracker<ResourceStateType>::Erase(ID3D12Resource* const resource) -> void {
+  resource_states_.erase(resource);
+}
+
 template<typename ResourceStateType>
 auto ResourceStateTracker<ResourceStateType>::Get(
   ID3D12Resource* const resource) const -> std::optional<ResourceStateType> {
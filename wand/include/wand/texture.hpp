@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 
 #include <wand/resource.hpp>
 
@@ -26,6 +28,8 @@ struct TextureDesc {
   bool render_target;
   bool shader_resource;
   bool unordered_access;
+
+  [[nodiscard]] auto operator==(TextureDesc const& other) const -> bool = default;
 };
 
 
@@ -48,14 +52,22 @@ public:
 private:
   Texture(Microsoft::WRL::ComPtr<D3D12MA::Allocation> allocation, Microsoft::WRL::ComPtr<ID3D12Resource2> resource,
           std::vector<UINT> dsvs, std::vector<UINT> rtvs, std::optional<UINT> srv, std::optional<UINT> uav,
-          TextureDesc const& desc);
+          TextureDesc const& desc, D3D12_CLEAR_VALUE const* clear_value);
 
   TextureDesc desc_;
   // One per mip
   std::vector<UINT> dsvs_;
   // One per mip
   std::vector<UINT> rtvs_;
+  // Kept for recreating the resource.
+  std::optional<D3D12_CLEAR_VALUE> clear_value_;
 
   friend GraphicsDevice;
 };
 }
+
+
+template<>
+struct std::hash<wand::TextureDesc> {
+  [[nodiscard]] auto operator()(wand::TextureDesc const& desc) const noexcept -> std::size_t;
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace wand::details {
+// Fixed set of worker threads running jobs in submission order. Jobs not yet started are discarded on destruction.
+class ThreadPool {
+public:
+  explicit ThreadPool(unsigned thread_count);
+
+  auto Submit(std::function<void()> job) -> void;
+
+private:
+  auto Run(std::stop_token const& stop_token) -> void;
+
+  std::deque<std::function<void()>> jobs_;
+  std::mutex mutex_;
+  std::condition_variable_any job_available_;
+  // Declared last so that the workers are joined before the jobs are destroyed.
+  std::vector<std::jthread> threads_;
+};
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include <wand/resource.hpp>
+
+namespace wand {
+struct TilePoolDesc {
+  UINT tile_count;
+  // Must restrict the pool to buffers or textures on devices with resource heap tier 1.
+  D3D12_HEAP_FLAGS heap_flags;
+};
+
+
+// Fixed set of 64KB tiles that reserved resources map into.
+class TilePool {
+public:
+  // Returns the index of a free tile, or nothing if the pool is exhausted.
+  [[nodiscard]] auto Allocate() -> std::optional<UINT>;
+  // The tile must not be mapped by any resource the GPU might still access.
+  auto Release(UINT tile) -> void;
+  [[nodiscard]] auto GetFreeTileCount() const -> UINT;
+  [[nodiscard]] auto GetTileCount() const -> UINT;
+
+private:
+  TilePool(Microsoft::WRL::ComPtr<D3D12MA::Allocation> allocation, UINT tile_count);
+
+  // Index of the first tile of the pool in its heap.
+  [[nodiscard]] auto GetHeapTileOffset() const -> UINT;
+
+  Microsoft::WRL::ComPtr<D3D12MA::Allocation> allocation_;
+  std::vector<UINT> free_tiles_;
+  UINT tile_count_;
+
+  friend GraphicsDevice;
+};
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include <wand/platforms/d3d12.hpp>
+
+namespace wand::details {
+// Two-level segregated fit allocator managing offsets within a range. Allocation and freeing take constant time.
+class TlsfAllocator {
+public:
+  explicit TlsfAllocator(UINT64 size);
+
+  // Returns the offset of the allocation, or nothing if no free block fits.
+  [[nodiscard]] auto Allocate(UINT64 size, UINT64 alignment) -> std::optional<UINT64>;
+  auto Free(UINT64 offset) -> void;
+
+  [[nodiscard]] auto GetSize() const -> UINT64;
+  [[nodiscard]] auto GetFreeSize() const -> UINT64;
+
+private:
+  static constexpr std::uint32_t kSecondLevelCountLog2{5};
+  static constexpr std::uint32_t kSecondLevelCount{1u << kSecondLevelCountLog2};
+  static constexpr std::uint32_t kFirstLevelCount{64 - kSecondLevelCountLog2 + 1};
+  static constexpr std::uint32_t kNullBlock{UINT32_MAX};
+
+  struct Block {
+    UINT64 offset;
+    UINT64 size;
+    std::uint32_t prev_physical;
+    std::uint32_t next_physical;
+    std::uint32_t prev_free;
+    std::uint32_t next_free;
+    bool free;
+  };
+
+  struct ListIndex {
+    std::uint32_t first_level;
+    std::uint32_t second_level;
+  };
+
+  // Index of the list the block of the size belongs to.
+  [[nodiscard]] static auto MapInsert(UINT64 size) -> ListIndex;
+  // Index of the first list whose blocks are all at least the size.
+  [[nodiscard]] static auto MapSearch(UINT64 size) -> ListIndex;
+
+  [[nodiscard]] auto FindFreeBlock(ListIndex idx) const -> std::uint32_t;
+  auto InsertFreeBlock(std::uint32_t block) -> void;
+  auto RemoveFreeBlock(std::uint32_t block) -> void;
+  // Splits the block after the size and returns the free remainder.
+  auto SplitBlock(std::uint32_t block, UINT64 size) -> std::uint32_t;
+  // Merges the next physical block into the block.
+  auto MergeBlocks(std::uint32_t block, std::uint32_t next) -> void;
+  [[nodiscard]] auto CreateBlock(UINT64 offset, UINT64 size) -> std::uint32_t;
+  auto DestroyBlock(std::uint32_t block) -> void;
+
+  std::vector<Block> blocks_;
+  std::vector<std::uint32_t> unused_blocks_;
+  std::array<std::array<std::uint32_t, kSecondLevelCount>, kFirstLevelCount> free_lists_;
+  std::uint64_t first_level_bitmap_{0};
+  std::array<std::uint32_t, kFirstLevelCount> second_level_bitmaps_{};
+  std::unordered_map<UINT64, std::uint32_t> allocated_blocks_;
+  UINT64 size_;
+  UINT64 free_size_;
+};
+}
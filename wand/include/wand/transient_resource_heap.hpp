@@ -0,0 +1,65 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include <wand/buffer.hpp>
+#include <wand/device_child.hpp>
+#include <wand/texture.hpp>
+
+namespace wand {
+// Lifetimes are specified as inclusive pass ranges in the order the passes execute within a frame.
+struct TransientBufferDesc {
+  BufferDesc desc;
+  UINT first_pass;
+  UINT last_pass;
+};
+
+
+struct TransientTextureDesc {
+  TextureDesc desc;
+  D3D12_CLEAR_VALUE const* clear_value;
+  UINT first_pass;
+  UINT last_pass;
+};
+
+
+namespace details {
+struct TransientAllocation {
+  UINT64 size;
+  UINT64 alignment;
+  UINT first_pass;
+  UINT last_pass;
+  UINT64 offset;
+};
+
+
+// Assigns offsets so that allocations with overlapping lifetimes never overlap in memory. Returns the required size.
+[[nodiscard]] auto PackTransientAllocations(std::span<TransientAllocation> allocations) -> UINT64;
+}
+
+
+// Resources used only within a frame, placed in shared memory so that resources with disjoint lifetimes alias.
+// Contents don't survive the passes of the resources. The heap can be reused in every frame with the same pass order.
+class TransientResourceHeap {
+public:
+  [[nodiscard]] auto GetBuffer(UINT idx) const -> Buffer const&;
+  [[nodiscard]] auto GetTexture(UINT idx) const -> Texture const&;
+  // Total size of the memory backing the resources.
+  [[nodiscard]] auto GetSize() const -> UINT64;
+
+private:
+  TransientResourceHeap(std::vector<SharedDeviceChildHandle<Buffer>> buffers, std::vector<UINT> buffer_first_passes,
+                        std::vector<SharedDeviceChildHandle<Texture>> textures,
+                        std::vector<UINT> texture_first_passes, UINT64 size);
+
+  std::vector<SharedDeviceChildHandle<Buffer>> buffers_;
+  std::vector<UINT> buffer_first_passes_;
+  std::vector<SharedDeviceChildHandle<Texture>> textures_;
+  std::vector<UINT> texture_first_passes_;
+  UINT64 size_;
+
+  friend GraphicsDevice;
+  friend class CommandList;
+};
+}
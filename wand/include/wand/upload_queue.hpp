@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include <wand/buffer.hpp>
+#include <wand/device_child.hpp>
+#include <wand/texture.hpp>
+
+namespace wand {
+struct UploadQueueDesc {
+  // Maximum number of jobs recorded into one copy command list, 0 records every pending job into a single one.
+  UINT max_batch_size;
+  // Submits jobs as they arrive on a thread owned by the queue instead of on GraphicsDevice::SubmitUploads calls.
+  bool dedicated_thread;
+};
+
+
+// Completion handle of an upload job.
+class UploadTicket {
+public:
+  // Returns the copy queue submission the job was recorded into, or 0 while the job is pending.
+  [[nodiscard]] auto GetSubmission() const -> UINT64;
+  [[nodiscard]] auto IsSubmitted() const -> bool;
+
+private:
+  explicit UploadTicket(std::shared_ptr<std::atomic<UINT64>> submission);
+
+  std::shared_ptr<std::atomic<UINT64>> submission_;
+
+  friend class UploadQueue;
+};
+
+
+namespace details {
+struct UploadJob {
+  SharedDeviceChildHandle<Buffer> staging;
+  UINT64 staging_offset;
+  // Buffer jobs have no destination texture.
+  Buffer const* dst_buffer;
+  UINT64 dst_offset;
+  UINT64 size;
+  Texture const* dst_texture;
+  UINT dst_subresource;
+  D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprint;
+  std::shared_ptr<std::atomic<UINT64>> submission;
+  UploadJob* next;
+};
+}
+
+
+// Collects copies of staging memory into resources from any number of threads without locking.
+// Destinations must stay alive until the copies complete. Jobs not yet submitted are discarded on destruction.
+class UploadQueue {
+public:
+  UploadQueue(UploadQueue const&) = delete;
+  UploadQueue(UploadQueue&&) = delete;
+
+  ~UploadQueue();
+
+  auto operator=(UploadQueue const&) -> void = delete;
+  auto operator=(UploadQueue&&) -> void = delete;
+
+  auto EnqueueBufferUpload(SharedDeviceChildHandle<Buffer> staging, UINT64 staging_offset, Buffer const& dst,
+                           UINT64 dst_offset, UINT64 size) -> UploadTicket;
+  // The footprint locates the subresource data in the staging buffer.
+  auto EnqueueTextureUpload(SharedDeviceChildHandle<Buffer> staging,
+                            D3D12_PLACED_SUBRESOURCE_FOOTPRINT const& footprint, Texture const& dst,
+                            UINT dst_subresource) -> UploadTicket;
+
+  [[nodiscard]] auto GetDesc() const -> UploadQueueDesc const&;
+
+private:
+  UploadQueue(GraphicsDevice& device, UploadQueueDesc const& desc);
+
+  auto Enqueue(details::UploadJob* job) -> UploadTicket;
+  // Detaches the pending jobs in submission order. The caller owns the returned list.
+  [[nodiscard]] auto TakeJobs() -> details::UploadJob*;
+  auto RunSubmitThread(std::stop_token const& stop_token) -> void;
+
+  GraphicsDevice* device_;
+  UploadQueueDesc desc_;
+  // Intrusive stack of pending jobs, most recent first.
+  std::atomic<details::UploadJob*> head_{nullptr};
+  // Incremented after each push, the submit thread waits on it.
+  std::atomic<UINT64> pending_job_count_{0};
+  std::jthread submit_thread_;
+
+  friend GraphicsDevice;
+};
+}
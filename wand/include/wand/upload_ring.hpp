@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <wand/buffer.hpp>
+#include <wand/descriptor_heap.hpp>
+#include <wand/device_child.hpp>
+#include <wand/fence.hpp>
+
+namespace wand {
+struct UploadRingDesc {
+  // Size of the region each frame allocates from.
+  UINT64 frame_size;
+  UINT frame_count;
+  // Number of transient constant buffer views each frame can create.
+  UINT constant_buffers_per_frame;
+};
+
+
+struct UploadAllocation {
+  std::span<std::byte> cpu_data;
+  D3D12_GPU_VIRTUAL_ADDRESS gpu_address;
+  Buffer const* buffer;
+  UINT64 offset;
+  // Transient constant buffer view, valid until the region of the frame is reclaimed.
+  std::optional<UINT> constant_buffer;
+};
+
+
+namespace details {
+struct UploadRingFrame {
+  Fence const* fence;
+  UINT64 completion_val;
+};
+}
+
+
+// Linear allocator over a persistently mapped upload buffer carved into per-frame regions.
+// Allocations are valid until the region of the frame they were made in is reused.
+class UploadRing {
+public:
+  // Waits for the GPU to finish with the region of the current frame, then resets it.
+  auto BeginFrame() -> void;
+  // The region of the current frame is reclaimed once the fence reaches the value. The fence must outlive the ring.
+  auto EndFrame(Fence const& fence, UINT64 completion_value) -> void;
+
+  [[nodiscard]] auto Allocate(UINT64 size, UINT64 alignment) -> UploadAllocation;
+  // Allocates with constant buffer alignment and creates a transient constant buffer view over the allocation.
+  [[nodiscard]] auto AllocateConstantBuffer(UINT64 size) -> UploadAllocation;
+
+  [[nodiscard]] auto GetBuffer() const -> Buffer const&;
+
+private:
+  UploadRing(SharedDeviceChildHandle<Buffer> buffer, ID3D12Device& device, details::DescriptorHeap& res_desc_heap,
+             std::vector<UINT> constant_buffers, UploadRingDesc const& desc);
+
+  SharedDeviceChildHandle<Buffer> buffer_;
+  ID3D12Device* device_;
+  details::DescriptorHeap* res_desc_heap_;
+  // Pre-allocated constant buffer view indices, constant_buffers_per_frame for each frame.
+  std::vector<UINT> constant_buffers_;
+  std::vector<details::UploadRingFrame> frames_;
+  UploadRingDesc desc_;
+  UINT frame_idx_{0};
+  std::atomic<UINT64> frame_offset_{0};
+  std::atomic<UINT> frame_constant_buffer_count_{0};
+
+  friend GraphicsDevice;
+};
+}
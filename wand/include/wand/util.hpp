@@ -1,10 +1,19 @@
 #pragma once
 
 #include <concepts>
+#include <cstddef>
 
 namespace wand {
 template<std::integral To, std::integral From>
 [[nodiscard]] constexpr auto ClampCast(From what) -> To;
+
+// Rounds the value up to the next multiple of the alignment.
+template<std::unsigned_integral T>
+[[nodiscard]] constexpr auto AlignUp(T value, T alignment) -> T;
+
+// Mixes the hash of the value into the seed.
+template<typename T>
+auto HashCombine(std::size_t& seed, T const& value) -> void;
 }
 
 #include <wand/util.inl>
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <functional>
 #include <limits>
 #include <utility>
 
@@ -21,4 +22,16 @@ constexpr auto ClampCast(From const what) -> To {
     }
   }
 }
+
+
+template<std::unsigned_integral T>
+constexpr auto AlignUp(T const value, T const alignment) -> T {
+  return alignment == 0 ? value : (value + alignment - 1) / alignment * alignment;
+}
+
+
+template<typename T>
+auto HashCombine(std::size_t& seed, T const& value) -> void {
+  seed ^= std::hash<T>{}(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
 }
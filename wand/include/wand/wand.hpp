@@ -1,40 +1,159 @@
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <concepts>
 #include <cstdint>
+#include <filesystem>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <span>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <wand/buffer.hpp>
+#include <wand/bundle.hpp>
 #include <wand/command_list.hpp>
+#include <wand/command_signature_cache.hpp>
 #include <wand/descriptor_heap.hpp>
 #include <wand/device_child.hpp>
 #include <wand/fence.hpp>
+#include <wand/geometry_pool.hpp>
+#include <wand/indirect_command.hpp>
+#include <wand/memory_pool.hpp>
 #include <wand/pipeline.hpp>
+#include <wand/pipeline_library.hpp>
+#include <wand/queue.hpp>
+#include <wand/readback.hpp>
+#include <wand/residency_manager.hpp>
+#include <wand/resource_pool.hpp>
 #include <wand/resource_state_tracker.hpp>
 #include <wand/root_signature_cache.hpp>
 #include <wand/sampler.hpp>
 #include <wand/swapchain.hpp>
 #include <wand/texture.hpp>
+#include <wand/thread_pool.hpp>
+#include <wand/tile_pool.hpp>
+#include <wand/transient_resource_heap.hpp>
+#include <wand/upload_queue.hpp>
+#include <wand/upload_ring.hpp>
 #include <wand/platforms/d3d12.hpp>
 
 
 namespace wand {
-enum class CpuAccess : std::uint8_t {
-  kNone = 0,
-  kRead = 1,
-  kWrite = 2
+struct AliasedTextureCreateInfo {
+  TextureDesc desc;
+  D3D12_BARRIER_LAYOUT initial_layout;
+  D3D12_CLEAR_VALUE* clear_value;
 };
 
 
-struct AliasedTextureCreateInfo {
+// Resources without an offset are placed after the preceding resources, honoring their alignment.
+struct PlacedBufferCreateInfo {
+  BufferDesc desc;
+  std::optional<UINT64> offset;
+};
+
+
+struct PlacedTextureCreateInfo {
   TextureDesc desc;
   D3D12_BARRIER_LAYOUT initial_layout;
   D3D12_CLEAR_VALUE* clear_value;
+  std::optional<UINT64> offset;
+};
+
+
+// Maps a region of a reserved resource to tiles of a pool, one pool tile for each tile in the region.
+struct TileRegionMapping {
+  D3D12_TILED_RESOURCE_COORDINATE coordinate;
+  D3D12_TILE_REGION_SIZE size;
+  std::span<UINT const> pool_tiles;
+};
+
+
+struct SubresourceData {
+  void const* data;
+  UINT64 row_pitch;
+  UINT64 slice_pitch;
+};
+
+
+struct TextureUploadDesc {
+  Texture const* texture;
+  UINT first_subresource;
+  std::span<SubresourceData const> subresources;
+};
+
+
+struct MemoryBudget {
+  // Video memory on discrete adapters, all memory on UMA adapters.
+  UINT64 local_usage;
+  UINT64 local_budget;
+  // System memory on discrete adapters, zero on UMA adapters.
+  UINT64 non_local_usage;
+  UINT64 non_local_budget;
+};
+
+
+using BudgetCallback = std::function<void(MemoryBudget const& budget)>;
+
+
+struct MemoryUsage {
+  // Memory allocated from the system: heaps and committed resources.
+  UINT64 block_bytes;
+  UINT64 allocation_bytes;
+  UINT block_count;
+  UINT allocation_count;
+};
+
+
+enum class MemoryCategory : std::uint8_t {
+  kBuffer = 0,
+  kTexture = 1,
+  // Textures allowing render target or depth stencil access.
+  kRenderTarget = 2,
+  // Memory not attributed to the other categories, such as aliasing and transient resource memory and tile pools.
+  kOther = 3
+};
+
+
+constexpr std::size_t kMemoryCategoryCount{4};
+
+
+struct MemoryCategoryUsage {
+  UINT64 bytes;
+  UINT64 allocation_count;
+};
+
+
+struct MemoryStatistics {
+  MemoryUsage total;
+  MemoryUsage default_heap;
+  MemoryUsage upload_heap;
+  MemoryUsage readback_heap;
+  MemoryUsage custom_heap;
+  MemoryUsage gpu_upload_heap;
+  // Indexed by MemoryCategory.
+  std::array<MemoryCategoryUsage, kMemoryCategoryCount> categories;
+};
+
+
+struct UploadBenchmarkResult {
+  // Empty on devices without GPU upload heaps.
+  std::optional<double> direct_bytes_per_second;
+  double staging_bytes_per_second;
+};
+
+
+struct DefragmentationStats {
+  UINT64 bytes_moved;
+  // Memory released to the system by freeing emptied heaps.
+  UINT64 bytes_freed;
+  UINT allocations_moved;
+  UINT heaps_freed;
 };
 
 
@@ -43,12 +162,70 @@ struct ExecuteBarrierCmdListRecord {
   SharedDeviceChildHandle<CommandList> cmd_list;
   UINT64 fence_completion_val;
 };
+
+
+struct CommandQueue {
+  Microsoft::WRL::ComPtr<ID3D12CommandQueue> queue;
+  SharedDeviceChildHandle<Fence> fence;
+  std::vector<ExecuteBarrierCmdListRecord> execute_barrier_cmd_lists;
+  // Command lists executed since the last flush, in submission order.
+  std::vector<ID3D12CommandList*> pending_cmd_lists;
+  // The highest fence values of the other queues this queue already waits for.
+  std::array<UINT64, kQueueTypeCount> waited_fence_vals{};
+};
+
+
+// Synchronization required before a queue can access resources last accessed by other queues.
+struct QueueTransfer {
+  // Transitions out of layouts the target queue doesn't support, to be executed on the previous queues.
+  std::array<std::vector<D3D12_TEXTURE_BARRIER>, kQueueTypeCount> release_barriers;
+  std::array<UINT64, kQueueTypeCount> wait_fence_vals{};
+};
+
+
+struct CopyRecord {
+  SharedDeviceChildHandle<CommandList> cmd_list;
+  // Released once the copy queue fence reaches the completion value.
+  std::vector<SharedDeviceChildHandle<Buffer>> staging_buffers;
+  UINT64 fence_completion_val;
+};
+
+
+struct StreamingChunk {
+  SharedDeviceChildHandle<Buffer> buffer;
+  UINT64 fence_completion_val{0};
+};
+
+
+struct DefragmentationMove {
+  Resource* resource;
+  D3D12MA::Allocation* dst_allocation;
+  Microsoft::WRL::ComPtr<ID3D12Resource2> new_resource;
+  D3D12_BARRIER_LAYOUT layout{D3D12_BARRIER_LAYOUT_UNDEFINED};
+  bool copy{false};
+};
+
+
+struct MemoryCategoryCounter {
+  std::atomic<UINT64> bytes{0};
+  std::atomic<UINT64> allocation_count{0};
+};
+
+
+struct BudgetCallbackRecord {
+  UINT id;
+  // Fraction of the budget usage has to exceed in either memory segment group for the callback to be invoked.
+  float usage_ratio;
+  BudgetCallback callback;
+};
 }
 
 
 class GraphicsDevice {
 public:
-  explicit GraphicsDevice(bool enable_debug, bool use_sw_rendering);
+  // Pipeline states are cached in the file if the path is not empty. Adapter or driver changes discard the cache.
+  explicit GraphicsDevice(bool enable_debug, bool use_sw_rendering,
+                          std::filesystem::path const& pipeline_cache_path = {});
   GraphicsDevice(GraphicsDevice const&) = delete;
   GraphicsDevice(GraphicsDevice&&) = delete;
 
@@ -57,41 +234,156 @@ public:
   auto operator=(GraphicsDevice const&) -> void = delete;
   auto operator=(GraphicsDevice&&) -> void = delete;
 
+  // Resources are allocated from the default pools unless a pool with matching CPU access is specified.
+  // Buffers not larger than the sub-allocation threshold are sub-allocated from resources shared with other buffers.
   [[nodiscard]] auto CreateBuffer(BufferDesc const& desc,
-                                  CpuAccess cpu_access) -> SharedDeviceChildHandle<Buffer>;
+                                  CpuAccess cpu_access,
+                                  MemoryPool const* pool = nullptr) -> SharedDeviceChildHandle<Buffer>;
   [[nodiscard]] auto CreateTexture(TextureDesc const& desc,
                                    CpuAccess cpu_access,
-                                   D3D12_CLEAR_VALUE const* clear_value) -> SharedDeviceChildHandle<Texture>;
+                                   D3D12_CLEAR_VALUE const* clear_value,
+                                   MemoryPool const* pool = nullptr) -> SharedDeviceChildHandle<Texture>;
   [[nodiscard]] auto CreatePipelineState(PipelineDesc const& desc,
                                          std::uint8_t num_32_bit_params) -> SharedDeviceChildHandle<
     PipelineState>;
-  [[nodiscard]] auto CreateCommandList() -> SharedDeviceChildHandle<CommandList>;
+  // Returns immediately and compiles the pipeline state on a worker thread. The shader bytecode and other memory the
+  // description points to must stay alive until the pipeline state is ready. The fallback must have the same parameter
+  // count and pipeline type.
+  [[nodiscard]] auto CreatePipelineStateAsync(PipelineDesc const& desc, std::uint8_t num_32_bit_params,
+                                              SharedDeviceChildHandle<PipelineState> fallback = nullptr) ->
+    SharedDeviceChildHandle<PipelineState>;
+  [[nodiscard]] auto CreateCommandList(
+    QueueType queue_type = QueueType::kGraphics) -> SharedDeviceChildHandle<CommandList>;
+  [[nodiscard]] auto CreateBundle() -> SharedDeviceChildHandle<Bundle>;
   [[nodiscard]] auto CreateFence(UINT64 initial_value) -> SharedDeviceChildHandle<Fence>;
   [[nodiscard]] auto CreateSwapChain(SwapChainDesc const& desc,
                                      HWND window_handle) -> SharedDeviceChildHandle<SwapChain>;
   [[nodiscard]] auto CreateSampler(D3D12_SAMPLER_DESC const& desc) -> UniqueSamplerHandle;
+  [[nodiscard]] auto CreateUploadRing(UploadRingDesc const& desc) -> SharedDeviceChildHandle<UploadRing>;
+  [[nodiscard]] auto CreateMemoryPool(MemoryPoolDesc const& desc) -> SharedDeviceChildHandle<MemoryPool>;
+  // Reserved resources only have virtual address space. Their tiles are backed by tile pools through MapTiles.
+  [[nodiscard]] auto CreateReservedBuffer(BufferDesc const& desc) -> SharedDeviceChildHandle<Buffer>;
+  [[nodiscard]] auto CreateReservedTexture(TextureDesc const& desc,
+                                           D3D12_CLEAR_VALUE const* clear_value) -> SharedDeviceChildHandle<Texture>;
+  [[nodiscard]] auto CreateTilePool(TilePoolDesc const& desc) -> SharedDeviceChildHandle<TilePool>;
+  [[nodiscard]] auto CreateGeometryPool(GeometryPoolDesc const& desc) -> SharedDeviceChildHandle<GeometryPool>;
+  [[nodiscard]] auto CreateUploadQueue(UploadQueueDesc const& desc) -> SharedDeviceChildHandle<UploadQueue>;
+  [[nodiscard]] auto CreateResourcePool(ResourcePoolDesc const& desc) -> SharedDeviceChildHandle<ResourcePool>;
   auto CreateAliasingResources(std::span<BufferDesc const> buffer_descs,
                                std::span<AliasedTextureCreateInfo const> texture_infos,
                                CpuAccess cpu_access,
                                std::vector<SharedDeviceChildHandle<Buffer>>* buffers,
                                std::vector<SharedDeviceChildHandle<Texture>>* textures) -> void;
+  // Creates the resources at the offsets in a single allocation sized to fit all of them.
+  // Overlapping resources alias. Mixing buffers, RT/DS textures and other textures requires resource heap tier 2.
+  auto CreatePlacedResources(std::span<PlacedBufferCreateInfo const> buffer_infos,
+                             std::span<PlacedTextureCreateInfo const> texture_infos,
+                             CpuAccess cpu_access,
+                             std::vector<SharedDeviceChildHandle<Buffer>>* buffers,
+                             std::vector<SharedDeviceChildHandle<Texture>>* textures) -> void;
+  // Packs the resources into shared memory based on their lifetimes, which begin in CommandList::BeginTransientPass.
+  [[nodiscard]] auto CreateTransientResourceHeap(std::span<TransientBufferDesc const> buffer_descs,
+                                                 std::span<TransientTextureDesc const> texture_descs) ->
+    SharedDeviceChildHandle<TransientResourceHeap>;
 
   auto DestroyBuffer(Buffer const* buffer) const -> void;
   auto DestroyTexture(Texture const* texture) const -> void;
   auto DestroyPipelineState(PipelineState const* pipeline_state) const -> void;
   auto DestroyCommandList(CommandList const* command_list) const -> void;
+  auto DestroyBundle(Bundle const* bundle) const -> void;
   auto DestroyFence(Fence const* fence) const -> void;
   auto DestroySwapChain(SwapChain const* swap_chain) const -> void;
   auto DestroySampler(UINT sampler) const -> void;
+  auto DestroyUploadRing(UploadRing const* upload_ring) const -> void;
+  auto DestroyMemoryPool(MemoryPool const* memory_pool) const -> void;
+  auto DestroyTransientResourceHeap(TransientResourceHeap const* transient_resource_heap) const -> void;
+  auto DestroyTilePool(TilePool const* tile_pool) const -> void;
+  auto DestroyGeometryPool(GeometryPool const* geometry_pool) const -> void;
+  auto DestroyUploadQueue(UploadQueue const* upload_queue) const -> void;
+  auto DestroyResourcePool(ResourcePool const* resource_pool) const -> void;
 
-  auto WaitFence(Fence const& fence, UINT64 wait_value) const -> void;
-  auto SignalFence(Fence& fence) const -> void;
-  auto ExecuteCommandLists(std::span<CommandList const> cmd_lists) -> void;
-  auto WaitIdle() const -> void;
+  auto WaitFence(Fence const& fence, UINT64 wait_value, QueueType queue_type = QueueType::kGraphics) -> void;
+  auto SignalFence(Fence& fence, QueueType queue_type = QueueType::kGraphics) -> void;
+  // Waits for other queues and leaves queue specific texture layouts as the accessed resources require. Returns the
+  // submission, the value the fence of the queue reaches once the work completes.
+  auto ExecuteCommandLists(std::span<CommandList const> cmd_lists,
+                           QueueType queue_type = QueueType::kGraphics) -> UINT64;
+  [[nodiscard]] auto IsSubmissionComplete(QueueType queue_type, UINT64 submission) const -> bool;
+  // Flushes deferred work of the queue first so that the submission can complete.
+  auto WaitSubmission(QueueType queue_type, UINT64 submission) -> void;
+  auto WaitIdle() -> void;
+  auto SavePipelineCache() -> void;
+  // In deferred mode, executed command lists must stay alive and unreset until the next flush. Flushes happen
+  // explicitly, on presentation, on fence operations, when waiting for idle and when another queue depends on the work.
+  auto SetSubmitMode(SubmitMode mode) -> void;
+  auto Flush() -> void;
 
   auto ResizeSwapChain(SwapChain& swap_chain, UINT width, UINT height) -> void;
   auto Present(SwapChain const& swap_chain) -> void;
 
+  // Updates the tile mappings on the queue once other queues are done with the resource. Returns the submission after
+  // which the mappings are in effect. Newly mapped tiles have undefined contents.
+  auto MapTiles(Resource const& resource, TilePool const& pool, std::span<TileRegionMapping const> regions,
+                QueueType queue_type = QueueType::kGraphics) -> UINT64;
+  auto UnmapTiles(Resource const& resource, std::span<D3D12_TILED_RESOURCE_COORDINATE const> coordinates,
+                  std::span<D3D12_TILE_REGION_SIZE const> sizes,
+                  QueueType queue_type = QueueType::kGraphics) -> UINT64;
+
+  // Uploads through a single staging buffer on the copy queue. Returns the copy queue submission.
+  auto UploadTexture(Texture const& texture, std::span<SubresourceData const> subresources,
+                     UINT first_subresource = 0) -> UINT64;
+  auto UploadTextures(std::span<TextureUploadDesc const> uploads) -> UINT64;
+  // Copies the data into pooled staging memory on the copy queue.
+  [[nodiscard]] auto ReadbackBuffer(Buffer const& buffer, UINT64 offset, UINT64 size) -> Readback;
+  [[nodiscard]] auto ReadbackTexture(Texture const& texture, UINT subresource) -> Readback;
+  // Uploads on the copy queue through a fixed budget of staging chunks, waiting for chunks to free up as needed.
+  // Texture sources contain the subresources tightly packed. Returns the copy queue submission of the last chunk.
+  auto StreamBuffer(Buffer const& dst, UINT64 dst_offset, std::span<std::byte const> src) -> UINT64;
+  auto StreamTexture(Texture const& dst, UINT first_subresource, UINT subresource_count,
+                     std::span<std::byte const> src) -> UINT64;
+  auto UploadGeometry(GeometryPool const& pool, GeometryAllocation const& allocation,
+                      std::span<std::byte const> data) -> UINT64;
+  // The file is memory mapped and copied into the staging chunks directly.
+  auto StreamBuffer(Buffer const& dst, UINT64 dst_offset, std::filesystem::path const& path, UINT64 file_offset,
+                    UINT64 size) -> UINT64;
+  auto StreamTexture(Texture const& dst, UINT first_subresource, UINT subresource_count,
+                     std::filesystem::path const& path, UINT64 file_offset) -> UINT64;
+  // Lives in video memory, persistently mapped in a GPU upload heap if supported, otherwise filled by staging copies.
+  [[nodiscard]] auto CreateUploadableBuffer(BufferDesc const& desc) -> SharedDeviceChildHandle<Buffer>;
+  [[nodiscard]] auto IsDirectUploadSupported() const -> bool;
+  // Writes through the mapping of GPU upload heap buffers, otherwise streams through staging memory. Direct writes must
+  // not overlap GPU accesses to the range. Returns the copy queue submission, or 0 if no copy was needed.
+  auto WriteBuffer(Buffer const& dst, UINT64 dst_offset, std::span<std::byte const> src) -> UINT64;
+  [[nodiscard]] auto BenchmarkUploadPaths(UINT64 size, UINT iteration_count) -> UploadBenchmarkResult;
+  // Records the pending jobs in batches and submits them on the copy queue. Call it at frame boundaries for queues
+  // without a dedicated thread. Returns the copy queue submission of the last batch.
+  auto SubmitUploads(UploadQueue& queue) -> UINT64;
+
+  // The budget is refreshed once per frame on presentation.
+  [[nodiscard]] auto GetMemoryBudget() const -> MemoryBudget;
+  // The callback is invoked on every presentation, before the frame is submitted, while usage exceeds the ratio of the
+  // budget. Returns an identifier for unregistering the callback.
+  [[nodiscard]] auto RegisterBudgetCallback(float usage_ratio, BudgetCallback callback) -> UINT;
+  auto UnregisterBudgetCallback(UINT id) -> void;
+  [[nodiscard]] auto GetMemoryStatistics() const -> MemoryStatistics;
+  // Returns the allocator state as UTF-16 JSON. The detailed map lists every allocation with its resource debug name.
+  [[nodiscard]] auto BuildMemoryStatsJson(bool detailed_map) const -> std::wstring;
+  // When enabled, allocations that would exceed the budget fail instead of letting the OS page memory out.
+  auto SetBudgetEnforcement(bool enforce) -> void;
+  // Buffers created from the default pools up to the size are sub-allocated, unless their structure stride is not a
+  // power of two. Zero disables sub-allocation.
+  // The threshold can't exceed the size of the shared resources, which is 1 MiB.
+  auto SetBufferSubAllocationThreshold(UINT64 size) -> void;
+  // While local memory usage exceeds the ratio of the budget on presentation, the least recently used idle video memory
+  // is evicted until submissions use it again. Zero disables eviction. Resources shaders only reach through descriptor
+  // indices must be declared with CommandList::UseResource, otherwise they may be evicted while still in use.
+  auto SetEvictionThreshold(float usage_ratio) -> void;
+
+  // Compacts the default pools, or the pool, in passes moving at most the budgets (zero means unlimited). Descriptors
+  // of moved resources are rewritten in place. Previously recorded command lists must already be executed, and
+  // resources must not be destroyed during the call. Resources with CPU access, aliased or used by bundles never move.
+  auto Defragment(UINT64 budget_bytes, UINT budget_moves, MemoryPool const* pool = nullptr) -> DefragmentationStats;
+
   auto GetCopyableFootprints(TextureDesc const& desc, UINT first_subresource, UINT subresource_count,
                              UINT64 base_offset, D3D12_PLACED_SUBRESOURCE_FOOTPRINT* layouts,
                              UINT* row_counts, UINT64* row_sizes, UINT64* total_size) const -> void;
@@ -99,20 +391,92 @@ public:
 private:
   auto SwapChainCreateTextures(SwapChain& swap_chain) -> void;
 
-  auto CreateBufferViews(ID3D12Resource2& buffer, BufferDesc const& desc, UINT& cbv, UINT& srv,
+  auto CreateBufferViews(ID3D12Resource2& buffer, UINT64 offset, BufferDesc const& desc, UINT& cbv, UINT& srv,
                          UINT& uav) const -> void;
   auto CreateTextureViews(ID3D12Resource2& texture, TextureDesc const& desc, std::vector<UINT>& dsvs,
                           std::vector<UINT>& rtvs, std::optional<UINT>& srv,
                           std::optional<UINT>& uav) const -> void;
+  // Write views into already allocated descriptors, so resources can be replaced while keeping their indices.
+  auto WriteBufferViews(ID3D12Resource2& buffer, UINT64 offset, BufferDesc const& desc, UINT cbv, UINT srv,
+                        UINT uav) const -> void;
+  auto WriteTextureViews(ID3D12Resource2& texture, TextureDesc const& desc, std::span<UINT const> dsvs,
+                         std::span<UINT const> rtvs, std::optional<UINT> srv, std::optional<UINT> uav) const -> void;
+
+  // Expects the size to be within the sub-allocation threshold and the alignment to be a power of two.
+  [[nodiscard]] auto CreateSubAllocatedBuffer(BufferDesc const& desc, CpuAccess cpu_access,
+                                              UINT64 alignment) -> SharedDeviceChildHandle<Buffer>;
+  // Create resources in memory that is already allocated.
+  [[nodiscard]] auto CreateAliasingBuffer(Microsoft::WRL::ComPtr<D3D12MA::Allocation> const& allocation, UINT64 offset,
+                                          BufferDesc const& desc,
+                                          CpuAccess cpu_access) -> SharedDeviceChildHandle<Buffer>;
+  [[nodiscard]] auto CreateAliasingTexture(Microsoft::WRL::ComPtr<D3D12MA::Allocation> const& allocation,
+                                           UINT64 offset,
+                                           AliasedTextureCreateInfo const& info) -> SharedDeviceChildHandle<Texture>;
 
-  [[nodiscard]] auto AcquirePendingBarrierCmdList() -> CommandList&;
+  [[nodiscard]] auto GetOrCreateRootSignature(std::uint8_t num_32_bit_params) -> Microsoft::WRL::ComPtr<
+    ID3D12RootSignature>;
+  // Loads the pipeline state from the pipeline cache if possible. Safe to call from worker threads.
+  [[nodiscard]] auto CompilePipelineState(PipelineDesc const& desc, std::uint8_t num_32_bit_params,
+                                          ID3D12RootSignature& root_signature) const -> Microsoft::WRL::ComPtr<
+    ID3D12PipelineState>;
+  auto CreateCommandSignatures(std::uint8_t num_params, ID3D12RootSignature* root_signature) -> void;
+
+  // The following functions expect submit_mutex_ to be held.
+  auto PrepareQueueTransfer(ID3D12Resource* resource, QueueType queue_type, details::QueueTransfer& transfer) -> void;
+  auto ExecuteQueueTransfer(details::QueueTransfer const& transfer, QueueType queue_type) -> void;
+  [[nodiscard]] auto AcquirePendingBarrierCmdList(QueueType queue_type) -> CommandList&;
+  // Returns the signaled fence value.
+  auto SignalQueue(QueueType queue_type) -> UINT64;
+  // Submits the pending command lists of the queue in a single call and signals its fence.
+  auto FlushQueue(QueueType queue_type) -> void;
+  // Orders the tile mapping update after work accessing the resource and returns the submission it completes with.
+  auto UpdateTileMappings(ID3D12Resource& resource, std::span<D3D12_TILED_RESOURCE_COORDINATE const> coordinates,
+                          std::span<D3D12_TILE_REGION_SIZE const> sizes, ID3D12Heap* heap,
+                          std::span<D3D12_TILE_RANGE_FLAGS const> range_flags,
+                          std::span<UINT const> heap_range_start_offsets, std::span<UINT const> range_tile_counts,
+                          QueueType queue_type) -> UINT64;
+  // Makes the queue wait for the objects to be paged in.
+  auto MakeResident(std::span<ID3D12Pageable* const> pageables, QueueType queue_type) -> void;
+  auto EvictColdMemory() -> void;
+  // Returns the signaled fence value.
+  auto EnqueueSignal(ID3D12CommandQueue& queue, Fence& fence) const -> UINT64;
+
+  [[nodiscard]] auto GetQueue(QueueType queue_type) -> details::CommandQueue&;
+  [[nodiscard]] auto GetQueue(QueueType queue_type) const -> details::CommandQueue const&;
+
+  // The following functions expect copy_mutex_ to be held.
+  // Returns a record whose copy command list is free to record, releasing the staging buffers of completed copies.
+  [[nodiscard]] auto AcquireCopyRecord() -> details::CopyRecord&;
+  // Returns a readback buffer not referenced by any readback, sized to the next power of two.
+  [[nodiscard]] auto AcquireReadbackBuffer(UINT64 size) -> SharedDeviceChildHandle<Buffer>;
+  // Keeps the staging buffers alive until the copy completes.
+  auto SubmitCopyRecord(details::CopyRecord& record,
+                        std::vector<SharedDeviceChildHandle<Buffer>> staging_buffers) -> UINT64;
+  // Returns the next staging chunk once the copy queue finished reading it.
+  [[nodiscard]] auto AcquireStreamingChunk() -> details::StreamingChunk&;
+
+  // Refreshes the budget and invokes the callbacks whose thresholds are exceeded.
+  auto NotifyBudgetCallbacks() -> void;
+
+  // Tracks the residency of video memory the resource lives in.
+  auto RegisterResidency(D3D12MA::Allocation* allocation, ID3D12Resource* resource) const -> void;
+  auto UnregisterResidency(ID3D12Resource* resource) const -> void;
+  auto MakeResidentOnRelease(ID3D12Pageable& pageable) const -> void;
+  // Accounts for the memory of the resource if it owns its allocation. Untracked memory is derived from the totals.
+  auto TrackMemoryCategory(D3D12MA::Allocation* allocation, ID3D12Resource* resource, MemoryCategory category,
+                           bool allocated) const -> void;
 
   [[nodiscard]] auto MakeHeapType(CpuAccess cpu_access) const -> D3D12_HEAP_TYPE;
+  [[nodiscard]] auto MakeAllocationFlags() const -> D3D12MA::ALLOCATION_FLAGS;
+  [[nodiscard]] auto MakeAllocationDesc(CpuAccess cpu_access, MemoryPool const* pool) const -> D3D12MA::ALLOCATION_DESC;
 
   static UINT const rtv_heap_size_;
   static UINT const dsv_heap_size_;
   static UINT const res_desc_heap_size_;
   static UINT const sampler_heap_size_;
+  static UINT64 const streaming_chunk_size_;
+  static UINT const streaming_chunk_count_;
+  static UINT64 const buffer_page_size_;
 
   Microsoft::WRL::ComPtr<IDXGIFactory7> factory_;
   Microsoft::WRL::ComPtr<ID3D12Device10> device_;
@@ -123,20 +487,54 @@ private:
   std::unique_ptr<details::DescriptorHeap> res_desc_heap_;
   std::unique_ptr<details::DescriptorHeap> sampler_heap_;
 
-  Microsoft::WRL::ComPtr<ID3D12CommandQueue> queue_;
+  std::array<details::CommandQueue, kQueueTypeCount> queues_;
 
   details::RootSignatureCache root_signatures_;
+  details::CommandSignatureCache command_signatures_;
   details::GlobalResourceStateTracker global_resource_states_;
+  std::unique_ptr<details::ResidencyManager> residency_manager_;
+  // Null if no pipeline cache path was given.
+  std::unique_ptr<details::PipelineLibrary> pipeline_library_;
+  // Signaled once evicted memory is paged in again.
+  SharedDeviceChildHandle<Fence> residency_fence_;
+  std::atomic<float> eviction_threshold_{0.0f};
+
+  // Declared before the members holding buffers, destroying those buffers frees their ranges of the pages.
+  // Empty pages are released, except for one of each kind.
+  mutable std::vector<std::unique_ptr<details::BufferPage>> buffer_pages_;
+  std::atomic<UINT64> buffer_sub_allocation_threshold_{4096};
+  mutable std::mutex buffer_page_mutex_;
+
+  // Indexed by MemoryCategory, the other category is unused.
+  mutable std::array<details::MemoryCategoryCounter, kMemoryCategoryCount> memory_categories_;
 
   UINT swap_chain_flags_{0};
   UINT present_flags_{0};
 
-  SharedDeviceChildHandle<Fence> idle_fence_;
-  SharedDeviceChildHandle<Fence> execute_barrier_fence_;
+  std::mutex submit_mutex_;
+  SubmitMode submit_mode_{SubmitMode::kImmediate};
+
+  std::vector<details::CopyRecord> copy_records_;
+  // Keyed by buffer size.
+  std::unordered_map<UINT64, std::vector<SharedDeviceChildHandle<Buffer>>> readback_buffers_;
+  std::vector<details::StreamingChunk> streaming_chunks_;
+  std::size_t next_streaming_chunk_idx_{0};
+  std::mutex copy_mutex_;
 
-  std::vector<details::ExecuteBarrierCmdListRecord> execute_barrier_cmd_lists_;
-  std::mutex execute_barrier_mutex_;
+  // Created on the first defragmentation.
+  SharedDeviceChildHandle<CommandList> defragmentation_cmd_list_;
+
+  std::vector<details::BudgetCallbackRecord> budget_callbacks_;
+  UINT next_budget_callback_id_{0};
+  UINT frame_idx_{0};
+  std::atomic<bool> enforce_budget_{false};
+  std::mutex budget_mutex_;
 
   CD3DX12FeatureSupport supported_features_;
+
+  std::once_flag pipeline_compiler_init_;
+  // Created on the first asynchronous pipeline state creation. Declared last so that compilations in flight finish
+  // before the rest of the device is destroyed.
+  std::unique_ptr<details::ThreadPool> pipeline_compiler_;
 };
 }
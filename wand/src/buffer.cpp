@@ -1,8 +1,19 @@
 #include "wand/buffer.hpp"
 
+#include <tuple>
+
+#include "wand/util.hpp"
+
 using Microsoft::WRL::ComPtr;
 
 namespace wand {
+auto Buffer::SetDebugName(std::wstring_view const name) const -> void {
+  if (!page_) {
+    Resource::SetDebugName(name);
+  }
+}
+
+
 auto Buffer::GetDesc() const -> BufferDesc const& {
   return desc_;
 }
@@ -13,10 +24,93 @@ auto Buffer::GetConstantBuffer() const -> UINT {
 }
 
 
+auto Buffer::GetOffset() const -> UINT64 {
+  return offset_;
+}
+
+
+auto Buffer::IsSubAllocated() const -> bool {
+  return page_ != nullptr;
+}
+
+
+auto Buffer::GetGpuVirtualAddress() const -> D3D12_GPU_VIRTUAL_ADDRESS {
+  return GetInternalResource()->GetGPUVirtualAddress() + offset_;
+}
+
+
+auto Buffer::GetMappedData() const -> std::span<std::byte> {
+  return mapped_data_;
+}
+
+
+auto Buffer::Map() const -> void* {
+  if (mapped_data_.empty()) {
+    return Resource::Map();
+  }
+
+  if (cpu_access_ == CpuAccess::kRead) {
+    InvalidateRange(0, mapped_data_.size());
+  }
+
+  return mapped_data_.data();
+}
+
+
+auto Buffer::Unmap() const -> void {
+  if (mapped_data_.empty()) {
+    Resource::Unmap();
+  }
+}
+
+
+auto Buffer::FlushRange(UINT64 const offset, UINT64 const size) const -> void {
+  // Mapping again only increments the map count, the written range is passed to the matching unmap.
+  D3D12_RANGE constexpr read_range{0, 0};
+  std::ignore = InternalMap(0, &read_range);
+  D3D12_RANGE const written_range{offset_ + offset, offset_ + offset + size};
+  InternalUnmap(0, &written_range);
+}
+
+
+auto Buffer::InvalidateRange(UINT64 const offset, UINT64 const size) const -> void {
+  D3D12_RANGE const read_range{offset_ + offset, offset_ + offset + size};
+  std::ignore = InternalMap(0, &read_range);
+  D3D12_RANGE constexpr written_range{0, 0};
+  InternalUnmap(0, &written_range);
+}
+
+
 Buffer::Buffer(ComPtr<D3D12MA::Allocation> allocation, ComPtr<ID3D12Resource2> resource, std::optional<UINT> const cbv,
-               std::optional<UINT> const srv, std::optional<UINT> const uav, BufferDesc const& desc) :
+               std::optional<UINT> const srv, std::optional<UINT> const uav, BufferDesc const& desc,
+               CpuAccess const cpu_access, UINT64 const offset, details::BufferPage* const page) :
   Resource{std::move(allocation), std::move(resource), srv, uav},
   desc_{desc},
-  cbv_{cbv} {
+  cbv_{cbv},
+  cpu_access_{cpu_access},
+  offset_{offset},
+  page_{page} {
+  if (page_) {
+    if (page_->mapped_data) {
+      mapped_data_ = {page_->mapped_data + offset_, static_cast<std::size_t>(desc_.size)};
+    }
+  } else if (cpu_access_ != CpuAccess::kNone) {
+    // The CPU reads nothing at this point, readback data is explicitly invalidated before reading.
+    D3D12_RANGE constexpr read_range{0, 0};
+    mapped_data_ = {
+      static_cast<std::byte*>(InternalMap(0, &read_range)) + offset_, static_cast<std::size_t>(desc_.size)
+    };
+  }
+}
 }
+
+
+auto std::hash<wand::BufferDesc>::operator()(wand::BufferDesc const& desc) const noexcept -> std::size_t {
+  std::size_t seed{0};
+  wand::HashCombine(seed, desc.size);
+  wand::HashCombine(seed, desc.stride);
+  wand::HashCombine(seed, desc.constant_buffer);
+  wand::HashCombine(seed, desc.shader_resource);
+  wand::HashCombine(seed, desc.unordered_access);
+  return seed;
 }
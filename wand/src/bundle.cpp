@@ -0,0 +1,232 @@
+#include "wand/bundle.hpp"
+
+#include <stdexcept>
+
+#include "wand/command_recording.hpp"
+#include "wand/common.hpp"
+
+using Microsoft::WRL::ComPtr;
+
+namespace wand {
+namespace {
+// Bundles are recorded once and replayed, skipping their draws would drop them for good.
+auto GetReadyPipeline(PipelineState const& pipeline_state) -> ID3D12PipelineState* {
+  auto const ready_pipeline{pipeline_state.GetReadyPipeline()};
+
+  if (!ready_pipeline) {
+    throw std::runtime_error{"Failed to set bundle pipeline state: the pipeline is still compiling."};
+  }
+
+  return ready_pipeline;
+}
+}
+
+
+Bundle::~Bundle() {
+  ClearUsages();
+}
+
+
+auto Bundle::Begin(PipelineState const* pipeline_state) -> void {
+  ThrowIfFailed(allocator_->Reset(), "Failed to reset bundle allocator.");
+  ThrowIfFailed(cmd_list_->Reset(allocator_.Get(), pipeline_state ? GetReadyPipeline(*pipeline_state) : nullptr),
+                "Failed to reset bundle.");
+  // Bundles must set the same descriptor heaps as the command lists executing them.
+  details::RecordDescriptorHeaps(*cmd_list_, *res_desc_heap_, *sampler_heap_);
+  compute_pipeline_set_ = pipeline_state && pipeline_state->is_compute_;
+  pipeline_set_ = pipeline_state != nullptr;
+  pipeline_allows_ds_write_ = pipeline_state && pipeline_state->allows_ds_write_;
+  num_params_ = pipeline_state ? pipeline_state->num_params_ : 0;
+  SetRootSignature(num_params_);
+  ClearUsages();
+}
+
+
+auto Bundle::End() const -> void {
+  ThrowIfFailed(cmd_list_->Close(), "Failed to close bundle.");
+}
+
+
+auto Bundle::Dispatch(UINT const thread_group_count_x, UINT const thread_group_count_y,
+                      UINT const thread_group_count_z) const -> void {
+  cmd_list_->Dispatch(thread_group_count_x, thread_group_count_y, thread_group_count_z);
+}
+
+
+auto Bundle::DispatchIndirect(Buffer const& arg_buf, UINT64 const arg_offset, UINT const max_command_count,
+                              Buffer const* const count_buf, UINT64 const count_offset) -> void {
+  ExecuteIndirect(IndirectCommandType::kDispatch, arg_buf, arg_offset, max_command_count, count_buf, count_offset);
+}
+
+
+auto Bundle::DispatchMesh(UINT const thread_group_count_x, UINT const thread_group_count_y,
+                          UINT const thread_group_count_z) const -> void {
+  cmd_list_->DispatchMesh(thread_group_count_x, thread_group_count_y, thread_group_count_z);
+}
+
+
+auto Bundle::DispatchMeshIndirect(Buffer const& arg_buf, UINT64 const arg_offset, UINT const max_command_count,
+                                  Buffer const* const count_buf, UINT64 const count_offset) -> void {
+  ExecuteIndirect(IndirectCommandType::kDispatchMesh, arg_buf, arg_offset, max_command_count, count_buf,
+                  count_offset);
+}
+
+
+auto Bundle::DrawIndexedIndirect(Buffer const& arg_buf, UINT64 const arg_offset, UINT const max_command_count,
+                                 Buffer const* const count_buf, UINT64 const count_offset) -> void {
+  ExecuteIndirect(IndirectCommandType::kDrawIndexed, arg_buf, arg_offset, max_command_count, count_buf,
+                  count_offset);
+}
+
+
+auto Bundle::DrawIndexedInstanced(UINT const index_count_per_instance, UINT const instance_count,
+                                  UINT const start_index_location, INT const base_vertex_location,
+                                  UINT const start_instance_location) const -> void {
+  details::RecordDrawIndexedInstanced(*cmd_list_, index_count_per_instance, instance_count, start_index_location,
+                                      base_vertex_location, start_instance_location);
+}
+
+
+auto Bundle::DrawIndirect(Buffer const& arg_buf, UINT64 const arg_offset, UINT const max_command_count,
+                          Buffer const* const count_buf, UINT64 const count_offset) -> void {
+  ExecuteIndirect(IndirectCommandType::kDraw, arg_buf, arg_offset, max_command_count, count_buf, count_offset);
+}
+
+
+auto Bundle::DrawInstanced(UINT const vertex_count_per_instance, UINT const instance_count,
+                           UINT const start_vertex_location, UINT const start_instance_location) const -> void {
+  details::RecordDrawInstanced(*cmd_list_, vertex_count_per_instance, instance_count, start_vertex_location,
+                               start_instance_location);
+}
+
+
+auto Bundle::SetBlendFactor(std::span<FLOAT const, 4> const blend_factor) const -> void {
+  cmd_list_->OMSetBlendFactor(blend_factor.data());
+}
+
+
+auto Bundle::SetIndexBuffer(Buffer const& buf, DXGI_FORMAT const index_format) -> void {
+  DeclareUsage(buf, D3D12_BARRIER_SYNC_VERTEX_SHADING, D3D12_BARRIER_ACCESS_INDEX_BUFFER);
+  details::RecordIndexBuffer(*cmd_list_, buf, index_format);
+}
+
+
+auto Bundle::SetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY const primitive_topology) const -> void {
+  cmd_list_->IASetPrimitiveTopology(primitive_topology);
+}
+
+
+auto Bundle::SetStencilRef(UINT const stencil_ref) const -> void {
+  cmd_list_->OMSetStencilRef(stencil_ref);
+}
+
+
+auto Bundle::SetPipelineParameter(UINT const index, UINT const value) const -> void {
+  details::RecordPipelineParameters(*cmd_list_, index, std::span{&value, 1}, compute_pipeline_set_);
+}
+
+
+auto Bundle::SetPipelineParameters(UINT const index, std::span<UINT const> const values) const -> void {
+  details::RecordPipelineParameters(*cmd_list_, index, values, compute_pipeline_set_);
+}
+
+
+auto Bundle::SetConstantBuffer(UINT const param_idx, Buffer const& buf) -> void {
+  DeclareUsage(buf, D3D12_BARRIER_SYNC_ALL_SHADING, D3D12_BARRIER_ACCESS_CONSTANT_BUFFER);
+  SetPipelineParameter(param_idx, buf.GetConstantBuffer());
+}
+
+
+auto Bundle::SetShaderResource(UINT const param_idx, Buffer const& buf) -> void {
+  DeclareUsage(buf, D3D12_BARRIER_SYNC_ALL_SHADING, D3D12_BARRIER_ACCESS_SHADER_RESOURCE);
+  SetPipelineParameter(param_idx, buf.GetShaderResource());
+}
+
+
+auto Bundle::SetShaderResource(UINT const param_idx, Texture const& tex) -> void {
+  DeclareUsage(tex, D3D12_BARRIER_SYNC_ALL_SHADING, D3D12_BARRIER_ACCESS_SHADER_RESOURCE,
+               D3D12_BARRIER_LAYOUT_DIRECT_QUEUE_SHADER_RESOURCE);
+  SetPipelineParameter(param_idx, tex.GetShaderResource());
+}
+
+
+auto Bundle::SetUnorderedAccess(UINT const param_idx, Buffer const& buf) -> void {
+  DeclareUsage(buf, D3D12_BARRIER_SYNC_ALL_SHADING, D3D12_BARRIER_ACCESS_UNORDERED_ACCESS);
+  SetPipelineParameter(param_idx, buf.GetUnorderedAccess());
+}
+
+
+auto Bundle::SetUnorderedAccess(UINT const param_idx, Texture const& tex) -> void {
+  DeclareUsage(tex, D3D12_BARRIER_SYNC_ALL_SHADING, D3D12_BARRIER_ACCESS_UNORDERED_ACCESS,
+               D3D12_BARRIER_LAYOUT_DIRECT_QUEUE_UNORDERED_ACCESS);
+  SetPipelineParameter(param_idx, tex.GetUnorderedAccess());
+}
+
+
+auto Bundle::SetPipelineState(PipelineState const& pipeline_state) -> void {
+  cmd_list_->SetPipelineState(GetReadyPipeline(pipeline_state));
+  compute_pipeline_set_ = pipeline_state.is_compute_;
+  pipeline_set_ = true;
+  pipeline_allows_ds_write_ = pipeline_state.allows_ds_write_;
+  num_params_ = pipeline_state.num_params_;
+  SetRootSignature(num_params_);
+}
+
+
+auto Bundle::SetRootSignature(std::uint8_t const num_params) const -> void {
+  details::RecordRootSignature(*cmd_list_, *root_signatures_, num_params, compute_pipeline_set_);
+}
+
+
+Bundle::Bundle(ComPtr<ID3D12CommandAllocator> allocator, ComPtr<ID3D12GraphicsCommandList7> cmd_list,
+               details::DescriptorHeap const* res_desc_heap, details::DescriptorHeap const* sampler_heap,
+               details::RootSignatureCache* root_signatures, details::CommandSignatureCache* command_signatures) :
+  allocator_{std::move(allocator)},
+  cmd_list_{std::move(cmd_list)},
+  res_desc_heap_{res_desc_heap},
+  sampler_heap_{sampler_heap},
+  root_signatures_{root_signatures},
+  command_signatures_{command_signatures} {
+}
+
+
+auto Bundle::ExecuteIndirect(IndirectCommandType const type, Buffer const& arg_buf, UINT64 const arg_offset,
+                             UINT const max_command_count, Buffer const* const count_buf,
+                             UINT64 const count_offset) -> void {
+  DeclareUsage(arg_buf, D3D12_BARRIER_SYNC_EXECUTE_INDIRECT, D3D12_BARRIER_ACCESS_INDIRECT_ARGUMENT);
+
+  if (count_buf) {
+    DeclareUsage(*count_buf, D3D12_BARRIER_SYNC_EXECUTE_INDIRECT, D3D12_BARRIER_ACCESS_INDIRECT_ARGUMENT);
+  }
+
+  details::RecordExecuteIndirect(*cmd_list_, *command_signatures_, num_params_, type, arg_buf, arg_offset,
+                                 max_command_count, count_buf, count_offset);
+}
+
+
+auto Bundle::DeclareUsage(Buffer const& buf, D3D12_BARRIER_SYNC const sync, D3D12_BARRIER_ACCESS const access) -> void {
+  buffer_usages_.emplace_back(&buf, sync, access);
+  buf.bundle_usage_count_ += 1;
+}
+
+
+auto Bundle::DeclareUsage(Texture const& tex, D3D12_BARRIER_SYNC const sync, D3D12_BARRIER_ACCESS const access,
+                          D3D12_BARRIER_LAYOUT const layout) -> void {
+  texture_usages_.emplace_back(&tex, sync, access, layout);
+  tex.bundle_usage_count_ += 1;
+}
+
+
+auto Bundle::ClearUsages() -> void {
+  for (auto const& usage : buffer_usages_) {
+    usage.buffer->bundle_usage_count_ -= 1;
+  }
+
+  for (auto const& usage : texture_usages_) {
+    usage.texture->bundle_usage_count_ -= 1;
+  }
+
+  buffer_usages_.clear();
+  texture_usages_.clear();
+}
+}
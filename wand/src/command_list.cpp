@@ -1,10 +1,10 @@
 #include "wand/command_list.hpp"
 
 #include <algorithm>
-#include <array>
-#include <bit>
 #include <iterator>
+#include <stdexcept>
 
+#include "wand/command_recording.hpp"
 #include "wand/common.hpp"
 
 using Microsoft::WRL::ComPtr;
@@ -12,14 +12,27 @@ using Microsoft::WRL::ComPtr;
 namespace wand {
 auto CommandList::Begin(PipelineState const* pipeline_state) -> void {
   ThrowIfFailed(allocator_->Reset(), "Failed to reset command allocator.");
-  ThrowIfFailed(cmd_list_->Reset(allocator_.Get(), pipeline_state ? pipeline_state->pipeline_state_.Get() : nullptr),
-                "Failed to reset command list.");
-  cmd_list_->SetDescriptorHeaps(2,
-                                std::array{res_desc_heap_->GetInternalPtr(), sampler_heap_->GetInternalPtr()}.data());
-  compute_pipeline_set_ = pipeline_state && pipeline_state->is_compute_;
-  SetRootSignature(pipeline_state ? pipeline_state->num_params_ : 0);
   local_resource_states_.Clear();
   pending_barriers_.clear();
+  used_resources_.clear();
+
+  // Copy command lists cannot bind pipeline states, descriptor heaps or root signatures.
+  if (queue_type_ == QueueType::kCopy) {
+    ThrowIfFailed(cmd_list_->Reset(allocator_.Get(), nullptr), "Failed to reset command list.");
+    num_params_ = 0;
+    skip_draws_ = false;
+    return;
+  }
+
+  auto const ready_pipeline{pipeline_state ? pipeline_state->GetReadyPipeline() : nullptr};
+  skip_draws_ = pipeline_state && !ready_pipeline;
+
+  ThrowIfFailed(cmd_list_->Reset(allocator_.Get(), ready_pipeline), "Failed to reset command list.");
+  details::RecordDescriptorHeaps(*cmd_list_, *res_desc_heap_, *sampler_heap_);
+  // Compute queues only have compute root signature slots.
+  compute_pipeline_set_ = queue_type_ == QueueType::kCompute || (pipeline_state && pipeline_state->is_compute_);
+  num_params_ = pipeline_state ? pipeline_state->num_params_ : 0;
+  SetRootSignature(num_params_);
 }
 
 
@@ -52,17 +65,23 @@ auto CommandList::ClearRenderTarget(Texture const& tex, std::span<FLOAT const, 4
 
 
 auto CommandList::CopyBuffer(Buffer const& dst, Buffer const& src) -> void {
-  GenerateBarrier(src, D3D12_BARRIER_SYNC_COPY, D3D12_BARRIER_ACCESS_COPY_SOURCE);
-  GenerateBarrier(dst, D3D12_BARRIER_SYNC_COPY, D3D12_BARRIER_ACCESS_COPY_DEST);
-  cmd_list_->CopyResource(dst.GetInternalResource(), src.GetInternalResource());
+  // Sub-allocated buffers don't own their resources, so only their ranges are copied.
+  CopyBufferRegion(dst, 0, src, 0, src.GetDesc().size);
 }
 
 
 auto CommandList::CopyBufferRegion(Buffer const& dst, UINT64 const dst_offset, Buffer const& src,
                                    UINT64 const src_offset, UINT64 const num_bytes) -> void {
-  GenerateBarrier(src, D3D12_BARRIER_SYNC_COPY, D3D12_BARRIER_ACCESS_COPY_SOURCE);
-  GenerateBarrier(dst, D3D12_BARRIER_SYNC_COPY, D3D12_BARRIER_ACCESS_COPY_DEST);
-  cmd_list_->CopyBufferRegion(dst.GetInternalResource(), dst_offset, src.GetInternalResource(), src_offset, num_bytes);
+  if (dst.IsSubAllocated() && dst.GetInternalResource() == src.GetInternalResource()) {
+    // Buffers sub-allocated from the same resource are copied within it.
+    GenerateBarrier(dst, D3D12_BARRIER_SYNC_COPY, D3D12_BARRIER_ACCESS_COPY_SOURCE | D3D12_BARRIER_ACCESS_COPY_DEST);
+  } else {
+    GenerateBarrier(src, D3D12_BARRIER_SYNC_COPY, D3D12_BARRIER_ACCESS_COPY_SOURCE);
+    GenerateBarrier(dst, D3D12_BARRIER_SYNC_COPY, D3D12_BARRIER_ACCESS_COPY_DEST);
+  }
+
+  cmd_list_->CopyBufferRegion(dst.GetInternalResource(), dst.GetOffset() + dst_offset, src.GetInternalResource(),
+                              src.GetOffset() + src_offset, num_bytes);
 }
 
 
@@ -107,12 +126,30 @@ auto CommandList::CopyTextureRegion(Texture const& dst, UINT const dst_subresour
   };
   D3D12_TEXTURE_COPY_LOCATION const src_loc{
     .pResource = src.GetInternalResource(), .Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT,
-    .PlacedFootprint = src_footprint
+    .PlacedFootprint = {src.GetOffset() + src_footprint.Offset, src_footprint.Footprint}
   };
   cmd_list_->CopyTextureRegion(&dst_loc, dst_x, dst_y, dst_z, &src_loc, nullptr);
 }
 
 
+auto CommandList::CopyTextureRegion(Buffer const& dst, D3D12_PLACED_SUBRESOURCE_FOOTPRINT const& dst_footprint,
+                                    Texture const& src, UINT const src_subresource_index,
+                                    D3D12_BOX const* src_box) -> void {
+  GenerateBarrier(src, D3D12_BARRIER_SYNC_COPY, D3D12_BARRIER_ACCESS_COPY_SOURCE,
+                  D3D12_BARRIER_LAYOUT_DIRECT_QUEUE_COPY_SOURCE);
+  GenerateBarrier(dst, D3D12_BARRIER_SYNC_COPY, D3D12_BARRIER_ACCESS_COPY_DEST);
+  D3D12_TEXTURE_COPY_LOCATION const dst_loc{
+    .pResource = dst.GetInternalResource(), .Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT,
+    .PlacedFootprint = {dst.GetOffset() + dst_footprint.Offset, dst_footprint.Footprint}
+  };
+  D3D12_TEXTURE_COPY_LOCATION const src_loc{
+    .pResource = src.GetInternalResource(), .Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX,
+    .SubresourceIndex = src_subresource_index
+  };
+  cmd_list_->CopyTextureRegion(&dst_loc, 0, 0, 0, &src_loc, src_box);
+}
+
+
 auto CommandList::DiscardRenderTarget(Texture const& tex, std::optional<D3D12_DISCARD_REGION> const& region) -> void {
   GenerateBarrier(tex, D3D12_BARRIER_SYNC_RENDER_TARGET, D3D12_BARRIER_ACCESS_RENDER_TARGET,
                   D3D12_BARRIER_LAYOUT_RENDER_TARGET);
@@ -129,31 +166,96 @@ auto CommandList::DiscardDepthStencil(Texture const& tex, std::optional<D3D12_DI
 
 auto CommandList::Dispatch(UINT const thread_group_count_x, UINT const thread_group_count_y,
                            UINT const thread_group_count_z) const -> void {
+  if (skip_draws_) {
+    return;
+  }
+
   cmd_list_->Dispatch(thread_group_count_x, thread_group_count_y, thread_group_count_z);
 }
 
 
+auto CommandList::DispatchIndirect(Buffer const& arg_buf, UINT64 const arg_offset, UINT const max_command_count,
+                                   Buffer const* const count_buf, UINT64 const count_offset) -> void {
+  ExecuteIndirect(IndirectCommandType::kDispatch, arg_buf, arg_offset, max_command_count, count_buf, count_offset);
+}
+
+
 auto CommandList::DispatchMesh(UINT const thread_group_count_x, UINT const thread_group_count_y,
                                UINT const thread_group_count_z) const -> void {
+  if (skip_draws_) {
+    return;
+  }
+
   cmd_list_->DispatchMesh(thread_group_count_x, thread_group_count_y, thread_group_count_z);
 }
 
 
+auto CommandList::DispatchMeshIndirect(Buffer const& arg_buf, UINT64 const arg_offset, UINT const max_command_count,
+                                       Buffer const* const count_buf, UINT64 const count_offset) -> void {
+  ExecuteIndirect(IndirectCommandType::kDispatchMesh, arg_buf, arg_offset, max_command_count, count_buf,
+                  count_offset);
+}
+
+
+auto CommandList::DrawIndexedIndirect(Buffer const& arg_buf, UINT64 const arg_offset, UINT const max_command_count,
+                                      Buffer const* const count_buf, UINT64 const count_offset) -> void {
+  ExecuteIndirect(IndirectCommandType::kDrawIndexed, arg_buf, arg_offset, max_command_count, count_buf,
+                  count_offset);
+}
+
+
 auto CommandList::DrawIndexedInstanced(UINT const index_count_per_instance, UINT const instance_count,
                                        UINT const start_index_location, INT const base_vertex_location,
                                        UINT const start_instance_location) const -> void {
-  std::array const offsets{*std::bit_cast<UINT const*>(&base_vertex_location), start_instance_location};
-  cmd_list_->SetGraphicsRoot32BitConstants(1, static_cast<UINT>(offsets.size()), offsets.data(), 0);
-  cmd_list_->DrawIndexedInstanced(index_count_per_instance, instance_count, start_index_location, base_vertex_location,
-                                  start_instance_location);
+  if (skip_draws_) {
+    return;
+  }
+
+  details::RecordDrawIndexedInstanced(*cmd_list_, index_count_per_instance, instance_count, start_index_location,
+                                      base_vertex_location, start_instance_location);
+}
+
+
+auto CommandList::DrawIndirect(Buffer const& arg_buf, UINT64 const arg_offset, UINT const max_command_count,
+                               Buffer const* const count_buf, UINT64 const count_offset) -> void {
+  ExecuteIndirect(IndirectCommandType::kDraw, arg_buf, arg_offset, max_command_count, count_buf, count_offset);
 }
 
 
 auto CommandList::DrawInstanced(UINT const vertex_count_per_instance, UINT const instance_count,
                                 UINT const start_vertex_location, UINT const start_instance_location) const -> void {
-  std::array const offsets{0u, start_instance_location};
-  cmd_list_->SetGraphicsRoot32BitConstants(1, static_cast<UINT>(offsets.size()), offsets.data(), 0);
-  cmd_list_->DrawInstanced(vertex_count_per_instance, instance_count, start_vertex_location, start_instance_location);
+  if (skip_draws_) {
+    return;
+  }
+
+  details::RecordDrawInstanced(*cmd_list_, vertex_count_per_instance, instance_count, start_vertex_location,
+                               start_instance_location);
+}
+
+
+auto CommandList::ExecuteBundle(Bundle const& bundle) -> void {
+  if (queue_type_ != QueueType::kGraphics) {
+    throw std::runtime_error{"Failed to execute bundle: bundles can only be executed on graphics command lists."};
+  }
+
+  std::ranges::for_each(bundle.buffer_usages_, [this](details::BufferUsage const& usage) {
+    GenerateBarrier(*usage.buffer, usage.sync, usage.access);
+  });
+
+  std::ranges::for_each(bundle.texture_usages_, [this](details::TextureUsage const& usage) {
+    GenerateBarrier(*usage.texture, usage.sync, usage.access, usage.layout);
+  });
+
+  cmd_list_->ExecuteBundle(bundle.cmd_list_.Get());
+
+  // Bundles only bind compiled pipelines.
+  if (bundle.pipeline_set_) {
+    pipeline_allows_ds_write_ = bundle.pipeline_allows_ds_write_;
+    skip_draws_ = false;
+  }
+
+  compute_pipeline_set_ = bundle.compute_pipeline_set_;
+  num_params_ = bundle.num_params_;
 }
 
 
@@ -173,11 +275,7 @@ auto CommandList::SetBlendFactor(std::span<FLOAT const, 4> const blend_factor) c
 
 auto CommandList::SetIndexBuffer(Buffer const& buf, DXGI_FORMAT const index_format) -> void {
   GenerateBarrier(buf, D3D12_BARRIER_SYNC_VERTEX_SHADING, D3D12_BARRIER_ACCESS_INDEX_BUFFER);
-  D3D12_INDEX_BUFFER_VIEW const ibv{
-    buf.GetInternalResource()->GetGPUVirtualAddress(), static_cast<UINT>(buf.GetInternalResource()->GetDesc1().Width),
-    index_format
-  };
-  cmd_list_->IASetIndexBuffer(&ibv);
+  details::RecordIndexBuffer(*cmd_list_, buf, index_format);
 }
 
 
@@ -238,20 +336,12 @@ auto CommandList::SetViewports(std::span<D3D12_VIEWPORT const> const viewports)
 
 
 auto CommandList::SetPipelineParameter(UINT const index, UINT const value) const -> void {
-  if (compute_pipeline_set_) {
-    cmd_list_->SetComputeRoot32BitConstant(0, value, index);
-  } else {
-    cmd_list_->SetGraphicsRoot32BitConstant(0, value, index);
-  }
+  details::RecordPipelineParameters(*cmd_list_, index, std::span{&value, 1}, compute_pipeline_set_);
 }
 
 
 auto CommandList::SetPipelineParameters(UINT const index, std::span<UINT const> const values) const -> void {
-  if (compute_pipeline_set_) {
-    cmd_list_->SetComputeRoot32BitConstants(0, static_cast<UINT>(values.size()), values.data(), index);
-  } else {
-    cmd_list_->SetGraphicsRoot32BitConstants(0, static_cast<UINT>(values.size()), values.data(), index);
-  }
+  details::RecordPipelineParameters(*cmd_list_, index, values, compute_pipeline_set_);
 }
 
 
@@ -288,40 +378,105 @@ auto CommandList::SetUnorderedAccess(UINT const param_idx, Texture const& tex) -
 
 
 auto CommandList::SetPipelineState(PipelineState const& pipeline_state) -> void {
-  cmd_list_->SetPipelineState(pipeline_state.pipeline_state_.Get());
-  compute_pipeline_set_ = pipeline_state.is_compute_;
+  // The root signature and flags of the requested pipeline apply even while a fallback is bound in its place.
+  auto const ready_pipeline{pipeline_state.GetReadyPipeline()};
+  skip_draws_ = !ready_pipeline;
+
+  if (ready_pipeline) {
+    cmd_list_->SetPipelineState(ready_pipeline);
+  }
+
+  compute_pipeline_set_ = queue_type_ == QueueType::kCompute || pipeline_state.is_compute_;
   pipeline_allows_ds_write_ = pipeline_state.allows_ds_write_;
-  SetRootSignature(pipeline_state.num_params_);
+  num_params_ = pipeline_state.num_params_;
+  SetRootSignature(num_params_);
 }
 
 
-auto CommandList::SetRootSignature(std::uint8_t const num_params) const -> void {
-  if (compute_pipeline_set_) {
-    cmd_list_->SetComputeRootSignature(root_signatures_->Get(num_params).Get());
-  } else {
-    cmd_list_->SetGraphicsRootSignature(root_signatures_->Get(num_params).Get());
+auto CommandList::BeginTransientPass(TransientResourceHeap const& heap, UINT const pass) -> void {
+  // The first use waits for all preceding work, which covers the resources previously occupying the memory.
+  constexpr details::PipelineResourceState activated_state{
+    .sync = D3D12_BARRIER_SYNC_ALL, .access = D3D12_BARRIER_ACCESS_NO_ACCESS, .layout = D3D12_BARRIER_LAYOUT_UNDEFINED
+  };
+
+  for (std::size_t i{0}; i < heap.buffers_.size(); i++) {
+    if (heap.buffer_first_passes_[i] == pass) {
+      local_resource_states_.Record(heap.buffers_[i]->GetInternalResource(), activated_state);
+    }
+  }
+
+  for (std::size_t i{0}; i < heap.textures_.size(); i++) {
+    if (heap.texture_first_passes_[i] == pass) {
+      local_resource_states_.Record(heap.textures_[i]->GetInternalResource(), activated_state);
+    }
   }
 }
 
 
+auto CommandList::UseResource(Buffer const& buf) -> void {
+  used_resources_.emplace_back(buf.GetInternalResource());
+}
+
+
+auto CommandList::UseResource(Texture const& tex) -> void {
+  used_resources_.emplace_back(tex.GetInternalResource());
+}
+
+
+auto CommandList::GetQueueType() const -> QueueType {
+  return queue_type_;
+}
+
+
+auto CommandList::SetRootSignature(std::uint8_t const num_params) const -> void {
+  details::RecordRootSignature(*cmd_list_, *root_signatures_, num_params, compute_pipeline_set_);
+}
+
+
 CommandList::CommandList(ComPtr<ID3D12CommandAllocator> allocator, ComPtr<ID3D12GraphicsCommandList7> cmd_list,
                          details::DescriptorHeap const* dsv_heap, details::DescriptorHeap const* rtv_heap,
                          details::DescriptorHeap const* res_desc_heap, details::DescriptorHeap const* sampler_heap,
-                         details::RootSignatureCache* root_signatures) :
+                         details::RootSignatureCache* root_signatures,
+                         details::CommandSignatureCache* command_signatures, QueueType const queue_type) :
   allocator_{std::move(allocator)},
   cmd_list_{std::move(cmd_list)},
   dsv_heap_{dsv_heap},
   rtv_heap_{rtv_heap},
   res_desc_heap_{res_desc_heap},
   sampler_heap_{sampler_heap},
-  root_signatures_{root_signatures} {
+  root_signatures_{root_signatures},
+  command_signatures_{command_signatures},
+  queue_type_{queue_type} {
+}
+
+
+auto CommandList::ExecuteIndirect(IndirectCommandType const type, Buffer const& arg_buf, UINT64 const arg_offset,
+                                  UINT const max_command_count, Buffer const* const count_buf,
+                                  UINT64 const count_offset) -> void {
+  if (skip_draws_) {
+    return;
+  }
+
+  GenerateBarrier(arg_buf, D3D12_BARRIER_SYNC_EXECUTE_INDIRECT, D3D12_BARRIER_ACCESS_INDIRECT_ARGUMENT);
+
+  if (count_buf) {
+    GenerateBarrier(*count_buf, D3D12_BARRIER_SYNC_EXECUTE_INDIRECT, D3D12_BARRIER_ACCESS_INDIRECT_ARGUMENT);
+  }
+
+  details::RecordExecuteIndirect(*cmd_list_, *command_signatures_, num_params_, type, arg_buf, arg_offset,
+                                 max_command_count, count_buf, count_offset);
 }
 
 
 auto CommandList::GenerateBarrier(Buffer const& buf, D3D12_BARRIER_SYNC const sync,
                                   D3D12_BARRIER_ACCESS const access) -> void {
   auto const local_state{local_resource_states_.Get(buf.GetInternalResource())};
-  auto const needs_barrier{local_state && (local_state->access & access) == 0};
+  // Buffers sub-allocated from a page share the state of its resource, any access missing from it needs a barrier.
+  auto const needs_barrier{
+    local_state && (buf.IsSubAllocated()
+                      ? (local_state->access & access) != access
+                      : (local_state->access & access) == 0)
+  };
 
   if (!local_state || needs_barrier) {
     local_resource_states_.Record(buf.GetInternalResource(), {
@@ -340,7 +495,8 @@ auto CommandList::GenerateBarrier(Buffer const& buf, D3D12_BARRIER_SYNC const sy
 
 
 auto CommandList::GenerateBarrier(Texture const& tex, D3D12_BARRIER_SYNC const sync, D3D12_BARRIER_ACCESS const access,
-                                  D3D12_BARRIER_LAYOUT const layout) -> void {
+                                  D3D12_BARRIER_LAYOUT const direct_queue_layout) -> void {
+  auto const layout{details::MakeQueueSpecificLayout(direct_queue_layout, queue_type_)};
   auto const local_state{local_resource_states_.Get(tex.GetInternalResource())};
   auto const needs_barrier{local_state && ((local_state->layout & layout) == 0 || (local_state->access & access) == 0)};
 
@@ -353,12 +509,15 @@ auto CommandList::GenerateBarrier(Texture const& tex, D3D12_BARRIER_SYNC const s
   }
 
   if (needs_barrier) {
+    // Only transient textures are undefined here, and their contents are discarded once their lifetime begins.
     D3D12_TEXTURE_BARRIER const barrier{
       local_state->sync, sync, local_state->access, access, local_state->layout, layout, tex.GetInternalResource(), {
         .IndexOrFirstMipLevel = 0xffffffff, .NumMipLevels = 0, .FirstArraySlice = 0, .NumArraySlices = 0,
         .FirstPlane = 0, .NumPlanes = 0
       },
-      D3D12_TEXTURE_BARRIER_FLAG_NONE
+      local_state->layout == D3D12_BARRIER_LAYOUT_UNDEFINED
+        ? D3D12_TEXTURE_BARRIER_FLAG_DISCARD
+        : D3D12_TEXTURE_BARRIER_FLAG_NONE
     };
     D3D12_BARRIER_GROUP const group{.Type = D3D12_BARRIER_TYPE_TEXTURE, .NumBarriers = 1, .pTextureBarriers = &barrier};
     cmd_list_->Barrier(1, &group);
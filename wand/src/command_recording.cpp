@@ -0,0 +1,79 @@
+#include "wand/command_recording.hpp"
+
+#include <array>
+#include <bit>
+#include <stdexcept>
+
+namespace wand::details {
+auto RecordDescriptorHeaps(ID3D12GraphicsCommandList7& cmd_list, DescriptorHeap const& res_desc_heap,
+                           DescriptorHeap const& sampler_heap) -> void {
+  cmd_list.SetDescriptorHeaps(2, std::array{res_desc_heap.GetInternalPtr(), sampler_heap.GetInternalPtr()}.data());
+}
+
+
+auto RecordRootSignature(ID3D12GraphicsCommandList7& cmd_list, RootSignatureCache& root_signatures,
+                         std::uint8_t const num_params, bool const compute) -> void {
+  if (compute) {
+    cmd_list.SetComputeRootSignature(root_signatures.Get(num_params).Get());
+  } else {
+    cmd_list.SetGraphicsRootSignature(root_signatures.Get(num_params).Get());
+  }
+}
+
+
+auto RecordPipelineParameters(ID3D12GraphicsCommandList7& cmd_list, UINT const index,
+                              std::span<UINT const> const values, bool const compute) -> void {
+  if (compute) {
+    cmd_list.SetComputeRoot32BitConstants(0, static_cast<UINT>(values.size()), values.data(), index);
+  } else {
+    cmd_list.SetGraphicsRoot32BitConstants(0, static_cast<UINT>(values.size()), values.data(), index);
+  }
+}
+
+
+auto RecordIndexBuffer(ID3D12GraphicsCommandList7& cmd_list, Buffer const& buf,
+                       DXGI_FORMAT const index_format) -> void {
+  D3D12_INDEX_BUFFER_VIEW const ibv{
+    buf.GetGpuVirtualAddress(), static_cast<UINT>(buf.GetDesc().size), index_format
+  };
+  cmd_list.IASetIndexBuffer(&ibv);
+}
+
+
+auto RecordDrawIndexedInstanced(ID3D12GraphicsCommandList7& cmd_list, UINT const index_count_per_instance,
+                                UINT const instance_count, UINT const start_index_location,
+                                INT const base_vertex_location, UINT const start_instance_location) -> void {
+  std::array const offsets{*std::bit_cast<UINT const*>(&base_vertex_location), start_instance_location};
+  cmd_list.SetGraphicsRoot32BitConstants(1, static_cast<UINT>(offsets.size()), offsets.data(), 0);
+  cmd_list.DrawIndexedInstanced(index_count_per_instance, instance_count, start_index_location, base_vertex_location,
+                                start_instance_location);
+}
+
+
+auto RecordDrawInstanced(ID3D12GraphicsCommandList7& cmd_list, UINT const vertex_count_per_instance,
+                         UINT const instance_count, UINT const start_vertex_location,
+                         UINT const start_instance_location) -> void {
+  std::array const offsets{0u, start_instance_location};
+  cmd_list.SetGraphicsRoot32BitConstants(1, static_cast<UINT>(offsets.size()), offsets.data(), 0);
+  cmd_list.DrawInstanced(vertex_count_per_instance, instance_count, start_vertex_location, start_instance_location);
+}
+
+
+auto RecordExecuteIndirect(ID3D12GraphicsCommandList7& cmd_list, CommandSignatureCache& command_signatures,
+                           std::uint8_t const num_params, IndirectCommandType const type, Buffer const& arg_buf,
+                           UINT64 const arg_offset, UINT const max_command_count, Buffer const* const count_buf,
+                           UINT64 const count_offset) -> void {
+  auto const cmd_signature{command_signatures.Get(num_params, type)};
+
+  if (!cmd_signature) {
+    throw std::runtime_error{
+      "Failed to execute indirect commands: no command signature exists for the command type and parameter count."
+    };
+  }
+
+  cmd_list.ExecuteIndirect(cmd_signature.Get(), max_command_count,
+                           arg_buf.GetInternalResource(), arg_buf.GetOffset() + arg_offset,
+                           count_buf ? count_buf->GetInternalResource() : nullptr,
+                           count_buf ? count_buf->GetOffset() + count_offset : 0);
+}
+}
@@ -0,0 +1,23 @@
+#include "wand/command_signature_cache.hpp"
+
+using Microsoft::WRL::ComPtr;
+
+namespace wand::details {
+auto CommandSignatureCache::Add(std::uint8_t const num_params, IndirectCommandType const type,
+                                ComPtr<ID3D12CommandSignature> command_signature) -> ComPtr<ID3D12CommandSignature> {
+  std::scoped_lock const lock{mutex_};
+  return command_signatures_.try_emplace(std::pair{num_params, type}, std::move(command_signature)).first->second;
+}
+
+
+auto CommandSignatureCache::Get(std::uint8_t const num_params,
+                                IndirectCommandType const type) -> ComPtr<ID3D12CommandSignature> {
+  std::scoped_lock const lock{mutex_};
+
+  if (auto const it{command_signatures_.find(std::pair{num_params, type})}; it != std::end(command_signatures_)) {
+    return it->second;
+  }
+
+  return nullptr;
+}
+}
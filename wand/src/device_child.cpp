@@ -20,10 +20,26 @@ auto DeviceChildDeleter<T>::operator()(T const* device_child) -> void {
       device_->DestroyPipelineState(device_child);
     } else if constexpr (std::same_as<T, CommandList>) {
       device_->DestroyCommandList(device_child);
+    } else if constexpr (std::same_as<T, Bundle>) {
+      device_->DestroyBundle(device_child);
     } else if constexpr (std::same_as<T, Fence>) {
       device_->DestroyFence(device_child);
     } else if constexpr (std::same_as<T, SwapChain>) {
       device_->DestroySwapChain(device_child);
+    } else if constexpr (std::same_as<T, UploadRing>) {
+      device_->DestroyUploadRing(device_child);
+    } else if constexpr (std::same_as<T, MemoryPool>) {
+      device_->DestroyMemoryPool(device_child);
+    } else if constexpr (std::same_as<T, TransientResourceHeap>) {
+      device_->DestroyTransientResourceHeap(device_child);
+    } else if constexpr (std::same_as<T, TilePool>) {
+      device_->DestroyTilePool(device_child);
+    } else if constexpr (std::same_as<T, GeometryPool>) {
+      device_->DestroyGeometryPool(device_child);
+    } else if constexpr (std::same_as<T, UploadQueue>) {
+      device_->DestroyUploadQueue(device_child);
+    } else if constexpr (std::same_as<T, ResourcePool>) {
+      device_->DestroyResourcePool(device_child);
     }
   }
 }
@@ -32,6 +48,14 @@ template class DeviceChildDeleter<Buffer>;
 template class DeviceChildDeleter<Texture>;
 template class DeviceChildDeleter<PipelineState>;
 template class DeviceChildDeleter<CommandList>;
+template class DeviceChildDeleter<Bundle>;
 template class DeviceChildDeleter<Fence>;
 template class DeviceChildDeleter<SwapChain>;
+template class DeviceChildDeleter<UploadRing>;
+template class DeviceChildDeleter<MemoryPool>;
+template class DeviceChildDeleter<TransientResourceHeap>;
+template class DeviceChildDeleter<TilePool>;
+template class DeviceChildDeleter<GeometryPool>;
+template class DeviceChildDeleter<UploadQueue>;
+template class DeviceChildDeleter<ResourcePool>;
 }
@@ -0,0 +1,56 @@
+#include "wand/geometry_pool.hpp"
+
+#include <algorithm>
+
+namespace wand {
+auto GeometryPool::Allocate(UINT64 const size, UINT64 const alignment) -> std::optional<GeometryAllocation> {
+  // Raw views address the buffer in 4 byte units.
+  auto const view_alignment{std::max<UINT64>(alignment, 4)};
+
+  std::scoped_lock const lock{mutex_};
+
+  if (auto const offset{allocator_.Allocate(size, view_alignment)}) {
+    return GeometryAllocation{*offset, size};
+  }
+
+  return std::nullopt;
+}
+
+
+auto GeometryPool::Free(GeometryAllocation const& allocation) -> void {
+  std::scoped_lock const lock{mutex_};
+  allocator_.Free(allocation.offset);
+}
+
+
+auto GeometryPool::Use(CommandList& cmd_list) const -> void {
+  cmd_list.UseResource(*buffer_);
+}
+
+
+auto GeometryPool::GetBuffer() const -> Buffer const& {
+  return *buffer_;
+}
+
+
+auto GeometryPool::GetShaderResource() const -> UINT {
+  return buffer_->GetShaderResource();
+}
+
+
+auto GeometryPool::GetUnorderedAccess() const -> UINT {
+  return buffer_->GetUnorderedAccess();
+}
+
+
+auto GeometryPool::GetFreeSize() const -> UINT64 {
+  std::scoped_lock const lock{mutex_};
+  return allocator_.GetFreeSize();
+}
+
+
+GeometryPool::GeometryPool(SharedDeviceChildHandle<Buffer> buffer) :
+  buffer_{std::move(buffer)},
+  allocator_{buffer_->GetDesc().size} {
+}
+}
@@ -0,0 +1,24 @@
+#include "wand/indirect_command.hpp"
+
+#include <stdexcept>
+
+namespace wand {
+auto GetIndirectCommandStride(IndirectCommandType const type, std::uint8_t const num_params) -> UINT {
+  auto const params_size{static_cast<UINT>(num_params * sizeof(UINT))};
+  // Base vertex and base instance. Make sure this aligns with the shader code!
+  auto constexpr draw_offsets_size{static_cast<UINT>(2 * sizeof(UINT))};
+
+  switch (type) {
+  case IndirectCommandType::kDraw:
+    return params_size + draw_offsets_size + sizeof(D3D12_DRAW_ARGUMENTS);
+  case IndirectCommandType::kDrawIndexed:
+    return params_size + draw_offsets_size + sizeof(D3D12_DRAW_INDEXED_ARGUMENTS);
+  case IndirectCommandType::kDispatch:
+    return params_size + sizeof(D3D12_DISPATCH_ARGUMENTS);
+  case IndirectCommandType::kDispatchMesh:
+    return params_size + sizeof(D3D12_DISPATCH_MESH_ARGUMENTS);
+  }
+
+  throw std::runtime_error{"Failed to get indirect command stride: unknown indirect command type."};
+}
+}
@@ -0,0 +1,61 @@
+#include "wand/mapped_file.hpp"
+
+#include <stdexcept>
+
+namespace wand::details {
+MappedFile::MappedFile(std::filesystem::path const& path) {
+  file_ = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN,
+                      nullptr);
+
+  if (file_ == INVALID_HANDLE_VALUE) {
+    throw std::runtime_error{"Failed to open file for mapping."};
+  }
+
+  LARGE_INTEGER size;
+
+  if (!GetFileSizeEx(file_, &size)) {
+    CloseHandle(file_);
+    throw std::runtime_error{"Failed to query size of file to map."};
+  }
+
+  size_ = static_cast<std::size_t>(size.QuadPart);
+
+  // Empty files cannot be mapped.
+  if (size_ == 0) {
+    return;
+  }
+
+  mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+  if (!mapping_) {
+    CloseHandle(file_);
+    throw std::runtime_error{"Failed to create file mapping."};
+  }
+
+  view_ = MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+
+  if (!view_) {
+    CloseHandle(mapping_);
+    CloseHandle(file_);
+    throw std::runtime_error{"Failed to map view of file."};
+  }
+}
+
+
+MappedFile::~MappedFile() {
+  if (view_) {
+    UnmapViewOfFile(view_);
+  }
+
+  if (mapping_) {
+    CloseHandle(mapping_);
+  }
+
+  CloseHandle(file_);
+}
+
+
+auto MappedFile::GetData() const -> std::span<std::byte const> {
+  return {static_cast<std::byte const*>(view_), size_};
+}
+}
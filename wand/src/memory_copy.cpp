@@ -0,0 +1,49 @@
+#include "wand/memory_copy.hpp"
+
+#include <emmintrin.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace wand::details {
+auto StreamingCopy(void* const dst, void const* const src, std::size_t const size) -> void {
+  auto dst_bytes{static_cast<std::byte*>(dst)};
+  auto src_bytes{static_cast<std::byte const*>(src)};
+  auto remaining{size};
+
+  // Streaming stores require 16 byte aligned destinations.
+  if (auto const misalignment{reinterpret_cast<std::uintptr_t>(dst_bytes) % 16}; misalignment != 0) {
+    auto const head{std::min<std::size_t>(16 - misalignment, remaining)};
+    std::memcpy(dst_bytes, src_bytes, head);
+    dst_bytes += head;
+    src_bytes += head;
+    remaining -= head;
+  }
+
+  for (; remaining >= 64; remaining -= 64, dst_bytes += 64, src_bytes += 64) {
+    auto const src_vec{reinterpret_cast<__m128i const*>(src_bytes)};
+    auto const dst_vec{reinterpret_cast<__m128i*>(dst_bytes)};
+    auto const a{_mm_loadu_si128(src_vec)};
+    auto const b{_mm_loadu_si128(src_vec + 1)};
+    auto const c{_mm_loadu_si128(src_vec + 2)};
+    auto const d{_mm_loadu_si128(src_vec + 3)};
+    _mm_stream_si128(dst_vec, a);
+    _mm_stream_si128(dst_vec + 1, b);
+    _mm_stream_si128(dst_vec + 2, c);
+    _mm_stream_si128(dst_vec + 3, d);
+  }
+
+  for (; remaining >= 16; remaining -= 16, dst_bytes += 16, src_bytes += 16) {
+    _mm_stream_si128(reinterpret_cast<__m128i*>(dst_bytes),
+                     _mm_loadu_si128(reinterpret_cast<__m128i const*>(src_bytes)));
+  }
+
+  if (remaining > 0) {
+    std::memcpy(dst_bytes, src_bytes, remaining);
+  }
+
+  // Make the non-temporal stores visible before the GPU can be told to read the memory.
+  _mm_sfence();
+}
+}
@@ -0,0 +1,28 @@
+#include "wand/memory_pool.hpp"
+
+using Microsoft::WRL::ComPtr;
+
+namespace wand {
+auto MemoryPool::GetDesc() const -> MemoryPoolDesc const& {
+  return desc_;
+}
+
+
+auto MemoryPool::GetUsage(UINT64& allocation_bytes, UINT64& block_bytes) const -> void {
+  D3D12MA::Statistics stats;
+  pool_->GetStatistics(&stats);
+  allocation_bytes = stats.AllocationBytes;
+  block_bytes = stats.BlockBytes;
+}
+
+
+auto MemoryPool::SetDebugName(std::wstring_view const name) const -> void {
+  pool_->SetName(name.data());
+}
+
+
+MemoryPool::MemoryPool(ComPtr<D3D12MA::Pool> pool, MemoryPoolDesc const& desc) :
+  pool_{std::move(pool)},
+  desc_{desc} {
+}
+}
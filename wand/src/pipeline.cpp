@@ -1,14 +1,42 @@
 #include "wand/pipeline.hpp"
 
+#include <stdexcept>
+
 using Microsoft::WRL::ComPtr;
 
 namespace wand {
+auto PipelineState::IsReady() const -> bool {
+  return status_.load(std::memory_order_acquire) == details::PipelineStateStatus::kReady;
+}
+
+
+auto PipelineState::Wait() const -> void {
+  status_.wait(details::PipelineStateStatus::kCompiling, std::memory_order_acquire);
+
+  if (status_.load(std::memory_order_acquire) == details::PipelineStateStatus::kFailed) {
+    throw std::runtime_error{"Failed to compile pipeline state: " + error_};
+  }
+}
+
+
 PipelineState::PipelineState(ComPtr<ID3D12RootSignature> root_signature, ComPtr<ID3D12PipelineState> pipeline_state,
-                             std::uint8_t const num_params, bool const is_compute, bool const allows_ds_write) :
+                             SharedDeviceChildHandle<PipelineState> fallback, std::uint8_t const num_params,
+                             bool const is_compute, bool const allows_ds_write) :
   root_signature_{std::move(root_signature)},
   pipeline_state_{std::move(pipeline_state)},
+  fallback_{std::move(fallback)},
   num_params_{num_params},
   is_compute_{is_compute},
-  allows_ds_write_{allows_ds_write} {
+  allows_ds_write_{allows_ds_write},
+  status_{pipeline_state_ ? details::PipelineStateStatus::kReady : details::PipelineStateStatus::kCompiling} {
+}
+
+
+auto PipelineState::GetReadyPipeline() const -> ID3D12PipelineState* {
+  if (IsReady()) {
+    return pipeline_state_.Get();
+  }
+
+  return fallback_ ? fallback_->GetReadyPipeline() : nullptr;
 }
 }
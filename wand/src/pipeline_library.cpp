@@ -0,0 +1,280 @@
+#include "wand/pipeline_library.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+#include "wand/common.hpp"
+
+using Microsoft::WRL::ComPtr;
+
+namespace wand::details {
+namespace {
+// FNV-1a, the hash has to be the same in every run.
+auto HashBytes(UINT64& hash, void const* const data, std::size_t const size) -> void {
+  for (auto const byte : std::span{static_cast<std::byte const*>(data), size}) {
+    hash ^= static_cast<UINT64>(byte);
+    hash *= 1099511628211ull;
+  }
+}
+
+
+// Structs are hashed member by member as their padding bytes are not guaranteed to be initialized.
+template<typename T> requires std::is_arithmetic_v<T> || std::is_enum_v<T>
+auto HashValue(UINT64& hash, T const value) -> void {
+  HashBytes(hash, &value, sizeof(value));
+}
+
+
+auto HashShader(UINT64& hash, D3D12_SHADER_BYTECODE const& shader) -> void {
+  HashValue(hash, shader.BytecodeLength);
+  HashBytes(hash, shader.pShaderBytecode, shader.BytecodeLength);
+}
+
+
+auto HashStencilOp(UINT64& hash, D3D12_DEPTH_STENCILOP_DESC const& op) -> void {
+  HashValue(hash, op.StencilFailOp);
+  HashValue(hash, op.StencilDepthFailOp);
+  HashValue(hash, op.StencilPassOp);
+  HashValue(hash, op.StencilFunc);
+}
+}
+
+
+std::uint32_t const PipelineLibrary::magic_{0x4C505057}; // "WPPL"
+std::uint32_t const PipelineLibrary::version_{1};
+
+
+PipelineLibrary::PipelineLibrary(ID3D12Device1& device, IDXGIAdapter4& adapter, std::filesystem::path path) :
+  device_{&device},
+  path_{std::move(path)} {
+  DXGI_ADAPTER_DESC3 adapter_desc;
+  ThrowIfFailed(adapter.GetDesc3(&adapter_desc), "Failed to get adapter description.");
+
+  // User mode driver version, left at zero if the adapter doesn't report it.
+  LARGE_INTEGER driver_version;
+
+  if (FAILED(adapter.CheckInterfaceSupport(__uuidof(IDXGIDevice), &driver_version))) {
+    driver_version.QuadPart = 0;
+  }
+
+  header_ = PipelineLibraryHeader{
+    magic_, version_, adapter_desc.VendorId, adapter_desc.DeviceId, adapter_desc.SubSysId, adapter_desc.Revision,
+    driver_version.QuadPart, 0
+  };
+
+  if (std::error_code ec; std::filesystem::is_regular_file(path_, ec)) {
+    try {
+      file_ = std::make_unique<MappedFile>(path_);
+    } catch (std::runtime_error const&) {
+      // An unreadable cache is rebuilt.
+    }
+  }
+
+  if (file_) {
+    auto const data{file_->GetData()};
+    PipelineLibraryHeader file_header{};
+
+    if (data.size() >= sizeof(file_header)) {
+      std::memcpy(&file_header, data.data(), sizeof(file_header));
+    }
+
+    auto const blob{data.subspan(std::min(data.size(), sizeof(file_header)))};
+
+    // Anything but blob_size differing means the cache was written by another adapter, driver or format version.
+    if (file_header.magic == header_.magic && file_header.version == header_.version &&
+        file_header.vendor_id == header_.vendor_id && file_header.device_id == header_.device_id &&
+        file_header.sub_sys_id == header_.sub_sys_id && file_header.revision == header_.revision &&
+        file_header.driver_version == header_.driver_version && file_header.blob_size == blob.size()) {
+      // The runtime validates the blob too and rejects it after driver updates the header couldn't detect.
+      auto const hr{CreateLibrary(blob)};
+
+      if (SUCCEEDED(hr) || hr == DXGI_ERROR_UNSUPPORTED) {
+        return;
+      }
+
+      if (hr != D3D12_ERROR_ADAPTER_NOT_FOUND && hr != D3D12_ERROR_DRIVER_VERSION_MISMATCH && hr != E_INVALIDARG) {
+        ThrowIfFailed(hr, "Failed to create pipeline library.");
+      }
+    }
+
+    // The stale file is overwritten on the next save.
+    file_.reset();
+    dirty_ = true;
+  }
+
+  if (auto const hr{CreateLibrary({})}; hr != DXGI_ERROR_UNSUPPORTED) {
+    ThrowIfFailed(hr, "Failed to create pipeline library.");
+  }
+}
+
+
+auto PipelineLibrary::Load(std::wstring const& name,
+                           D3D12_PIPELINE_STATE_STREAM_DESC const& desc) -> ComPtr<ID3D12PipelineState> {
+  std::scoped_lock const lock{mutex_};
+
+  if (!library_) {
+    return nullptr;
+  }
+
+  ComPtr<ID3D12PipelineState> pipeline_state;
+
+  // Fails with E_INVALIDARG if the name is not found or the stored pipeline has a different description.
+  if (FAILED(library_->LoadPipeline(name.c_str(), &desc, IID_PPV_ARGS(&pipeline_state)))) {
+    return nullptr;
+  }
+
+  return pipeline_state;
+}
+
+
+auto PipelineLibrary::Store(std::wstring const& name, ID3D12PipelineState& pipeline_state) -> void {
+  std::scoped_lock const lock{mutex_};
+
+  // Storing fails if another thread stored a pipeline with the same name first, which is fine to ignore.
+  if (library_ && SUCCEEDED(library_->StorePipeline(name.c_str(), &pipeline_state))) {
+    dirty_ = true;
+  }
+}
+
+
+auto PipelineLibrary::Save() -> void {
+  std::scoped_lock const lock{mutex_};
+
+  if (!library_ || !dirty_) {
+    return;
+  }
+
+  std::vector<std::byte> blob(library_->GetSerializedSize());
+  ThrowIfFailed(library_->Serialize(blob.data(), blob.size()), "Failed to serialize pipeline library.");
+
+  // The mapped file cannot be overwritten, the library is recreated from the serialized copy instead.
+  library_.Reset();
+  file_.reset();
+  blob_ = std::move(blob);
+  ThrowIfFailed(CreateLibrary(blob_), "Failed to recreate pipeline library.");
+
+  auto header{header_};
+  header.blob_size = blob_.size();
+
+  std::ofstream out{path_, std::ios::binary | std::ios::trunc};
+
+  if (!out) {
+    throw std::runtime_error{"Failed to save pipeline library: the file could not be opened."};
+  }
+
+  out.write(reinterpret_cast<char const*>(&header), sizeof(header));
+  out.write(reinterpret_cast<char const*>(blob_.data()), static_cast<std::streamsize>(blob_.size()));
+
+  if (!out) {
+    throw std::runtime_error{"Failed to save pipeline library: the file could not be written."};
+  }
+
+  dirty_ = false;
+}
+
+
+auto PipelineLibrary::CreateLibrary(std::span<std::byte const> const blob) -> HRESULT {
+  return device_->CreatePipelineLibrary(blob.empty() ? nullptr : blob.data(), blob.size(), IID_PPV_ARGS(&library_));
+}
+
+
+auto HashPipelineDesc(PipelineDesc const& desc, std::uint8_t const num_32_bit_params) -> UINT64 {
+  UINT64 hash{14695981039346656037ull};
+
+  HashValue(hash, num_32_bit_params);
+  HashValue(hash, desc.primitive_topology_type);
+
+  for (auto const& shader : {desc.vs, desc.gs, desc.hs, desc.ds, desc.ps, desc.as, desc.ms, desc.cs}) {
+    HashShader(hash, shader);
+  }
+
+  HashValue(hash, desc.stream_output.NumEntries);
+
+  for (UINT i{0}; i < desc.stream_output.NumEntries; i++) {
+    auto const& entry{desc.stream_output.pSODeclaration[i]};
+    HashValue(hash, entry.Stream);
+
+    if (entry.SemanticName) {
+      std::string_view const semantic_name{entry.SemanticName};
+      HashValue(hash, semantic_name.size());
+      HashBytes(hash, semantic_name.data(), semantic_name.size());
+    }
+
+    HashValue(hash, entry.SemanticIndex);
+    HashValue(hash, entry.StartComponent);
+    HashValue(hash, entry.ComponentCount);
+    HashValue(hash, entry.OutputSlot);
+  }
+
+  HashValue(hash, desc.stream_output.NumStrides);
+  HashBytes(hash, desc.stream_output.pBufferStrides, desc.stream_output.NumStrides * sizeof(UINT));
+  HashValue(hash, desc.stream_output.RasterizedStream);
+
+  HashValue(hash, desc.blend_state.AlphaToCoverageEnable);
+  HashValue(hash, desc.blend_state.IndependentBlendEnable);
+
+  for (auto const& rt : desc.blend_state.RenderTarget) {
+    HashValue(hash, rt.BlendEnable);
+    HashValue(hash, rt.LogicOpEnable);
+    HashValue(hash, rt.SrcBlend);
+    HashValue(hash, rt.DestBlend);
+    HashValue(hash, rt.BlendOp);
+    HashValue(hash, rt.SrcBlendAlpha);
+    HashValue(hash, rt.DestBlendAlpha);
+    HashValue(hash, rt.BlendOpAlpha);
+    HashValue(hash, rt.LogicOp);
+    HashValue(hash, rt.RenderTargetWriteMask);
+  }
+
+  auto const& ds{desc.depth_stencil_state};
+  HashValue(hash, ds.DepthEnable);
+  HashValue(hash, ds.DepthWriteMask);
+  HashValue(hash, ds.DepthFunc);
+  HashValue(hash, ds.StencilEnable);
+  HashValue(hash, ds.StencilReadMask);
+  HashValue(hash, ds.StencilWriteMask);
+  HashStencilOp(hash, ds.FrontFace);
+  HashStencilOp(hash, ds.BackFace);
+  HashValue(hash, ds.DepthBoundsTestEnable);
+  HashValue(hash, desc.ds_format);
+
+  auto const& rs{desc.rasterizer_state};
+  HashValue(hash, rs.FillMode);
+  HashValue(hash, rs.CullMode);
+  HashValue(hash, rs.FrontCounterClockwise);
+  HashValue(hash, rs.DepthBias);
+  HashValue(hash, rs.DepthBiasClamp);
+  HashValue(hash, rs.SlopeScaledDepthBias);
+  HashValue(hash, rs.DepthClipEnable);
+  HashValue(hash, rs.MultisampleEnable);
+  HashValue(hash, rs.AntialiasedLineEnable);
+  HashValue(hash, rs.ForcedSampleCount);
+  HashValue(hash, rs.ConservativeRaster);
+
+  HashValue(hash, desc.rt_formats.NumRenderTargets);
+
+  for (auto const format : desc.rt_formats.RTFormats) {
+    HashValue(hash, format);
+  }
+
+  HashValue(hash, desc.sample_desc.Count);
+  HashValue(hash, desc.sample_desc.Quality);
+  HashValue(hash, desc.sample_mask);
+
+  HashValue(hash, desc.view_instancing_desc.ViewInstanceCount);
+
+  for (UINT i{0}; i < desc.view_instancing_desc.ViewInstanceCount; i++) {
+    HashValue(hash, desc.view_instancing_desc.pViewInstanceLocations[i].ViewportArrayIndex);
+    HashValue(hash, desc.view_instancing_desc.pViewInstanceLocations[i].RenderTargetArrayIndex);
+  }
+
+  HashValue(hash, desc.view_instancing_desc.Flags);
+
+  return hash;
+}
+}
@@ -0,0 +1,80 @@
+#include "wand/queue.hpp"
+
+#include <stdexcept>
+
+namespace wand::details {
+auto AsD3d12CommandListType(QueueType const queue_type) -> D3D12_COMMAND_LIST_TYPE {
+  switch (queue_type) {
+  case QueueType::kGraphics:
+    return D3D12_COMMAND_LIST_TYPE_DIRECT;
+  case QueueType::kCompute:
+    return D3D12_COMMAND_LIST_TYPE_COMPUTE;
+  case QueueType::kCopy:
+    return D3D12_COMMAND_LIST_TYPE_COPY;
+  }
+
+  throw std::runtime_error{"Failed to convert queue type to D3D12 command list type: unknown queue type."};
+}
+
+
+auto MakeQueueSpecificLayout(D3D12_BARRIER_LAYOUT const direct_queue_layout,
+                             QueueType const queue_type) -> D3D12_BARRIER_LAYOUT {
+  if (queue_type == QueueType::kGraphics) {
+    return direct_queue_layout;
+  }
+
+  // Copy queues only support the common layout.
+  if (queue_type == QueueType::kCopy) {
+    return direct_queue_layout == D3D12_BARRIER_LAYOUT_UNDEFINED
+             ? D3D12_BARRIER_LAYOUT_UNDEFINED
+             : D3D12_BARRIER_LAYOUT_COMMON;
+  }
+
+  switch (direct_queue_layout) {
+  case D3D12_BARRIER_LAYOUT_DIRECT_QUEUE_COMMON:
+    return D3D12_BARRIER_LAYOUT_COMPUTE_QUEUE_COMMON;
+  case D3D12_BARRIER_LAYOUT_DIRECT_QUEUE_GENERIC_READ:
+    return D3D12_BARRIER_LAYOUT_COMPUTE_QUEUE_GENERIC_READ;
+  case D3D12_BARRIER_LAYOUT_DIRECT_QUEUE_UNORDERED_ACCESS:
+    return D3D12_BARRIER_LAYOUT_COMPUTE_QUEUE_UNORDERED_ACCESS;
+  case D3D12_BARRIER_LAYOUT_DIRECT_QUEUE_SHADER_RESOURCE:
+    return D3D12_BARRIER_LAYOUT_COMPUTE_QUEUE_SHADER_RESOURCE;
+  case D3D12_BARRIER_LAYOUT_DIRECT_QUEUE_COPY_SOURCE:
+    return D3D12_BARRIER_LAYOUT_COMPUTE_QUEUE_COPY_SOURCE;
+  case D3D12_BARRIER_LAYOUT_DIRECT_QUEUE_COPY_DEST:
+    return D3D12_BARRIER_LAYOUT_COMPUTE_QUEUE_COPY_DEST;
+  default:
+    return direct_queue_layout;
+  }
+}
+
+
+auto IsLayoutSupportedOnQueue(D3D12_BARRIER_LAYOUT const layout, QueueType const queue_type) -> bool {
+  switch (queue_type) {
+  case QueueType::kGraphics: {
+    return layout != D3D12_BARRIER_LAYOUT_COMPUTE_QUEUE_COMMON &&
+           layout != D3D12_BARRIER_LAYOUT_COMPUTE_QUEUE_GENERIC_READ &&
+           layout != D3D12_BARRIER_LAYOUT_COMPUTE_QUEUE_UNORDERED_ACCESS &&
+           layout != D3D12_BARRIER_LAYOUT_COMPUTE_QUEUE_SHADER_RESOURCE &&
+           layout != D3D12_BARRIER_LAYOUT_COMPUTE_QUEUE_COPY_SOURCE &&
+           layout != D3D12_BARRIER_LAYOUT_COMPUTE_QUEUE_COPY_DEST;
+  }
+  case QueueType::kCompute: {
+    return layout == D3D12_BARRIER_LAYOUT_UNDEFINED || layout == D3D12_BARRIER_LAYOUT_COMMON ||
+           layout == D3D12_BARRIER_LAYOUT_GENERIC_READ || layout == D3D12_BARRIER_LAYOUT_UNORDERED_ACCESS ||
+           layout == D3D12_BARRIER_LAYOUT_SHADER_RESOURCE || layout == D3D12_BARRIER_LAYOUT_COPY_SOURCE ||
+           layout == D3D12_BARRIER_LAYOUT_COPY_DEST || layout == D3D12_BARRIER_LAYOUT_COMPUTE_QUEUE_COMMON ||
+           layout == D3D12_BARRIER_LAYOUT_COMPUTE_QUEUE_GENERIC_READ ||
+           layout == D3D12_BARRIER_LAYOUT_COMPUTE_QUEUE_UNORDERED_ACCESS ||
+           layout == D3D12_BARRIER_LAYOUT_COMPUTE_QUEUE_SHADER_RESOURCE ||
+           layout == D3D12_BARRIER_LAYOUT_COMPUTE_QUEUE_COPY_SOURCE ||
+           layout == D3D12_BARRIER_LAYOUT_COMPUTE_QUEUE_COPY_DEST;
+  }
+  case QueueType::kCopy: {
+    return layout == D3D12_BARRIER_LAYOUT_UNDEFINED || layout == D3D12_BARRIER_LAYOUT_COMMON;
+  }
+  }
+
+  throw std::runtime_error{"Failed to check layout support: unknown queue type."};
+}
+}
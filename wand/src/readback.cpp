@@ -0,0 +1,43 @@
+#include "wand/readback.hpp"
+
+#include <stdexcept>
+
+#include "wand/wand.hpp"
+
+namespace wand {
+auto Readback::IsReady() const -> bool {
+  return fence_->GetCompletedValue() >= completion_val_;
+}
+
+
+auto Readback::Wait() const -> void {
+  device_->WaitSubmission(QueueType::kCopy, completion_val_);
+}
+
+
+auto Readback::GetData() const -> std::span<std::byte const> {
+  if (!IsReady()) {
+    throw std::runtime_error{"Failed to get readback data: the readback is not ready yet."};
+  }
+
+  staging_buffer_->InvalidateRange(0, size_);
+  return staging_buffer_->GetMappedData().first(static_cast<std::size_t>(size_));
+}
+
+
+auto Readback::GetFootprint() const -> D3D12_PLACED_SUBRESOURCE_FOOTPRINT const& {
+  return footprint_;
+}
+
+
+Readback::Readback(GraphicsDevice& device, SharedDeviceChildHandle<Buffer> staging_buffer, UINT64 const size,
+                   SharedDeviceChildHandle<Fence const> fence, UINT64 const completion_val,
+                   D3D12_PLACED_SUBRESOURCE_FOOTPRINT const& footprint) :
+  device_{&device},
+  staging_buffer_{std::move(staging_buffer)},
+  size_{size},
+  fence_{std::move(fence)},
+  completion_val_{completion_val},
+  footprint_{footprint} {
+}
+}
@@ -0,0 +1,140 @@
+#include "wand/residency_manager.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace wand::details {
+auto ResidencyManager::Register(ID3D12Resource* const resource, ID3D12Pageable* const pageable,
+                                UINT64 const size) -> void {
+  std::scoped_lock const lock{mutex_};
+
+  if (resource_objects_.try_emplace(resource, pageable).second) {
+    Acquire(pageable, size).resource_count += 1;
+  }
+}
+
+
+auto ResidencyManager::Unregister(ID3D12Resource* const resource) -> ID3D12Pageable* {
+  std::scoped_lock const lock{mutex_};
+
+  auto const it{resource_objects_.find(resource)};
+
+  if (it == std::end(resource_objects_)) {
+    return nullptr;
+  }
+
+  auto const pageable{it->second};
+  resource_objects_.erase(it);
+
+  auto& object{objects_.at(pageable)};
+  object.resource_count -= 1;
+  auto const evicted{ReleaseIfUnreferenced(pageable, object)};
+
+  // Committed resources are destroyed together with their object.
+  return evicted == resource ? nullptr : evicted;
+}
+
+
+auto ResidencyManager::Pin(ID3D12Pageable* const pageable, UINT64 const size) -> void {
+  std::scoped_lock const lock{mutex_};
+  Acquire(pageable, size).pin_count += 1;
+}
+
+
+auto ResidencyManager::Unpin(ID3D12Pageable* const pageable) -> ID3D12Pageable* {
+  std::scoped_lock const lock{mutex_};
+
+  if (auto const it{objects_.find(pageable)}; it != std::end(objects_)) {
+    it->second.pin_count -= 1;
+    return ReleaseIfUnreferenced(pageable, it->second);
+  }
+
+  return nullptr;
+}
+
+
+auto ResidencyManager::MarkUsed(ID3D12Resource* const resource, QueueType const queue_type, UINT64 const fence_val,
+                                std::vector<ID3D12Pageable*>& to_make_resident) -> void {
+  std::scoped_lock const lock{mutex_};
+
+  auto const it{resource_objects_.find(resource)};
+
+  if (it == std::end(resource_objects_)) {
+    return;
+  }
+
+  auto& object{objects_.at(it->second)};
+  auto& last_used_fence_val{object.last_used_fence_vals[static_cast<std::size_t>(queue_type)]};
+  last_used_fence_val = std::max(last_used_fence_val, fence_val);
+
+  if (object.resident) {
+    lru_.splice(std::begin(lru_), lru_, object.lru_it);
+  } else {
+    // The object is resident by the time the submission executes.
+    to_make_resident.emplace_back(it->second);
+    object.resident = true;
+    object.lru_it = lru_.emplace(std::begin(lru_), it->second);
+  }
+}
+
+
+auto ResidencyManager::Trim(UINT64 const bytes,
+                            std::span<UINT64 const, kQueueTypeCount> const completed_fence_vals) -> std::vector<
+  ID3D12Pageable*> {
+  std::scoped_lock const lock{mutex_};
+
+  std::vector<ID3D12Pageable*> evicted;
+  UINT64 evicted_bytes{0};
+
+  for (auto it{std::rbegin(lru_)}; it != std::rend(lru_) && evicted_bytes < bytes;) {
+    auto& object{objects_.at(*it)};
+
+    auto is_idle{object.pin_count == 0};
+
+    for (std::size_t i{0}; i < kQueueTypeCount; i++) {
+      is_idle = is_idle && object.last_used_fence_vals[i] <= completed_fence_vals[i];
+    }
+
+    if (!is_idle) {
+      ++it;
+      continue;
+    }
+
+    evicted.emplace_back(*it);
+    evicted_bytes += object.size;
+    object.resident = false;
+    // Erasing through the base iterator leaves the reverse iterator at the next more recently used object.
+    it = std::make_reverse_iterator(lru_.erase(std::next(it).base()));
+  }
+
+  return evicted;
+}
+
+
+auto ResidencyManager::Acquire(ID3D12Pageable* const pageable, UINT64 const size) -> TrackedObject& {
+  auto const [it, inserted]{objects_.try_emplace(pageable, TrackedObject{.size = size})};
+
+  if (inserted) {
+    it->second.lru_it = lru_.emplace(std::begin(lru_), pageable);
+  }
+
+  return it->second;
+}
+
+
+auto ResidencyManager::ReleaseIfUnreferenced(ID3D12Pageable* const pageable,
+                                             TrackedObject const& object) -> ID3D12Pageable* {
+  if (object.resource_count != 0 || object.pin_count != 0) {
+    return nullptr;
+  }
+
+  auto const resident{object.resident};
+
+  if (resident) {
+    lru_.erase(object.lru_it);
+  }
+
+  objects_.erase(pageable);
+  return resident ? nullptr : pageable;
+}
+}
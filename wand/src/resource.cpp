@@ -7,6 +7,11 @@ using Microsoft::WRL::ComPtr;
 namespace wand {
 auto Resource::SetDebugName(std::wstring_view const name) const -> void {
   ThrowIfFailed(resource_->SetName(name.data()), "Failed to set D3D12 resource debug name.");
+
+  // Tags the allocation in memory statistics, unless the memory is shared with other resources.
+  if (allocation_ && allocation_->GetResource() == resource_.Get()) {
+    allocation_->SetName(name.data());
+  }
 }
 
 
@@ -41,6 +46,11 @@ Resource::Resource(ComPtr<D3D12MA::Allocation> allocation, ComPtr<ID3D12Resource
   resource_{std::move(resource)},
   srv_{srv},
   uav_{uav} {
+  // Lets defragmentation find the resource that owns a moved allocation. Aliasing resources share their allocation and
+  // would leave it pointing at whichever of them was destroyed last.
+  if (allocation_ && allocation_->GetResource() == resource_.Get()) {
+    allocation_->SetPrivateData(this);
+  }
 }
 
 
@@ -0,0 +1,141 @@
+#include "wand/resource_pool.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+#include "wand/wand.hpp"
+
+namespace wand {
+namespace {
+template<typename T>
+[[nodiscard]] auto IsReleased(details::PooledResource<T> const& pooled) -> bool {
+  return pooled.resource.use_count() == 1;
+}
+
+
+// Only the union member the texture type uses is compared, the rest of the bytes are indeterminate.
+[[nodiscard]] auto ClearValuesMatch(std::optional<D3D12_CLEAR_VALUE> const& lhs, D3D12_CLEAR_VALUE const* const rhs,
+                                    bool const depth_stencil) -> bool {
+  if (!lhs || !rhs) {
+    return !lhs && !rhs;
+  }
+
+  if (lhs->Format != rhs->Format) {
+    return false;
+  }
+
+  if (depth_stencil) {
+    return lhs->DepthStencil.Depth == rhs->DepthStencil.Depth && lhs->DepthStencil.Stencil == rhs->DepthStencil.Stencil;
+  }
+
+  return std::ranges::equal(lhs->Color, rhs->Color);
+}
+
+
+// Released resources may still be accessed by the frames in flight.
+template<typename T>
+[[nodiscard]] auto IsIdle(details::PooledResource<T> const& pooled, UINT64 const frame_idx,
+                          UINT const frames_in_flight) -> bool {
+  return IsReleased(pooled) && frame_idx - pooled.last_used_frame >= frames_in_flight;
+}
+
+
+// Refreshes the frames of the resources still in use and erases the released ones the predicate selects.
+template<typename Desc, typename T, typename Pred>
+auto EraseReleased(std::unordered_multimap<Desc, details::PooledResource<T>>& resources, UINT64 const frame_idx,
+                   Pred const pred) -> void {
+  for (auto it{std::begin(resources)}; it != std::end(resources);) {
+    if (auto& pooled{it->second}; !IsReleased(pooled)) {
+      pooled.last_used_frame = frame_idx;
+      ++it;
+    } else if (pred(pooled)) {
+      it = resources.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+}
+
+
+auto ResourcePool::AcquireBuffer(BufferDesc const& desc,
+                                 CpuAccess const cpu_access) -> SharedDeviceChildHandle<Buffer> {
+  std::scoped_lock const lock{mutex_};
+
+  for (auto [it, last]{buffers_.equal_range(desc)}; it != last; ++it) {
+    if (auto& pooled{it->second};
+      IsIdle(pooled, frame_idx_, desc_.frames_in_flight) && pooled.cpu_access == cpu_access) {
+      pooled.last_used_frame = frame_idx_;
+      return pooled.resource;
+    }
+  }
+
+  auto buffer{device_->CreateBuffer(desc, cpu_access)};
+  buffers_.emplace(desc, details::PooledResource<Buffer>{buffer, cpu_access, std::nullopt, frame_idx_});
+  return buffer;
+}
+
+
+auto ResourcePool::AcquireTexture(TextureDesc const& desc, CpuAccess const cpu_access,
+                                  D3D12_CLEAR_VALUE const* const clear_value) -> SharedDeviceChildHandle<Texture> {
+  std::scoped_lock const lock{mutex_};
+
+  for (auto [it, last]{textures_.equal_range(desc)}; it != last; ++it) {
+    if (auto& pooled{it->second};
+      IsIdle(pooled, frame_idx_, desc_.frames_in_flight) && pooled.cpu_access == cpu_access &&
+      ClearValuesMatch(pooled.clear_value, clear_value, desc.depth_stencil)) {
+      pooled.last_used_frame = frame_idx_;
+      return pooled.resource;
+    }
+  }
+
+  auto texture{device_->CreateTexture(desc, cpu_access, clear_value)};
+  textures_.emplace(desc, details::PooledResource<Texture>{
+                      texture, cpu_access,
+                      clear_value ? std::optional{*clear_value} : std::nullopt, frame_idx_
+                    });
+  return texture;
+}
+
+
+auto ResourcePool::NextFrame() -> void {
+  std::scoped_lock const lock{mutex_};
+
+  ++frame_idx_;
+
+  auto const is_expired{
+    [this](auto const& pooled) {
+      return frame_idx_ - pooled.last_used_frame > desc_.retention_frame_count;
+    }
+  };
+
+  EraseReleased(buffers_, frame_idx_, is_expired);
+  EraseReleased(textures_, frame_idx_, is_expired);
+}
+
+
+auto ResourcePool::Trim() -> void {
+  std::scoped_lock const lock{mutex_};
+
+  auto const is_idle{
+    [this](auto const& pooled) {
+      return IsIdle(pooled, frame_idx_, desc_.frames_in_flight);
+    }
+  };
+
+  EraseReleased(buffers_, frame_idx_, is_idle);
+  EraseReleased(textures_, frame_idx_, is_idle);
+}
+
+
+auto ResourcePool::GetResourceCount() const -> std::size_t {
+  std::scoped_lock const lock{mutex_};
+  return buffers_.size() + textures_.size();
+}
+
+
+ResourcePool::ResourcePool(GraphicsDevice& device, ResourcePoolDesc const& desc) :
+  device_{&device},
+  desc_{desc} {
+}
+}
@@ -2,6 +2,8 @@
 
 #include <cmath>
 
+#include "wand/util.hpp"
+
 using Microsoft::WRL::ComPtr;
 
 namespace wand {
@@ -38,10 +40,28 @@ auto Texture::GetRenderTargetView(UINT const mip_index) const -> UINT {
 
 Texture::Texture(ComPtr<D3D12MA::Allocation> allocation, ComPtr<ID3D12Resource2> resource, std::vector<UINT> dsvs,
                  std::vector<UINT> rtvs, std::optional<UINT> const srv, std::optional<UINT> const uav,
-                 TextureDesc const& desc) :
+                 TextureDesc const& desc, D3D12_CLEAR_VALUE const* const clear_value) :
   Resource{std::move(allocation), std::move(resource), srv, uav},
   desc_{desc},
   dsvs_{std::move(dsvs)},
-  rtvs_{std::move(rtvs)} {
+  rtvs_{std::move(rtvs)},
+  clear_value_{clear_value ? std::optional{*clear_value} : std::nullopt} {
+}
 }
+
+
+auto std::hash<wand::TextureDesc>::operator()(wand::TextureDesc const& desc) const noexcept -> std::size_t {
+  std::size_t seed{0};
+  wand::HashCombine(seed, desc.dimension);
+  wand::HashCombine(seed, desc.width);
+  wand::HashCombine(seed, desc.height);
+  wand::HashCombine(seed, desc.depth_or_array_size);
+  wand::HashCombine(seed, desc.mip_levels);
+  wand::HashCombine(seed, desc.format);
+  wand::HashCombine(seed, desc.sample_count);
+  wand::HashCombine(seed, desc.depth_stencil);
+  wand::HashCombine(seed, desc.render_target);
+  wand::HashCombine(seed, desc.shader_resource);
+  wand::HashCombine(seed, desc.unordered_access);
+  return seed;
 }
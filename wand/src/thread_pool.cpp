@@ -0,0 +1,45 @@
+#include "wand/thread_pool.hpp"
+
+namespace wand::details {
+ThreadPool::ThreadPool(unsigned const thread_count) {
+  threads_.reserve(thread_count);
+
+  for (unsigned i{0}; i < thread_count; i++) {
+    threads_.emplace_back([this](std::stop_token const& stop_token) {
+      Run(stop_token);
+    });
+  }
+}
+
+
+auto ThreadPool::Submit(std::function<void()> job) -> void {
+  {
+    std::scoped_lock const lock{mutex_};
+    jobs_.emplace_back(std::move(job));
+  }
+
+  job_available_.notify_one();
+}
+
+
+auto ThreadPool::Run(std::stop_token const& stop_token) -> void {
+  while (true) {
+    std::function<void()> job;
+
+    {
+      std::unique_lock lock{mutex_};
+
+      if (!job_available_.wait(lock, stop_token, [this] {
+        return !jobs_.empty();
+      })) {
+        return;
+      }
+
+      job = std::move(jobs_.front());
+      jobs_.pop_front();
+    }
+
+    job();
+  }
+}
+}
@@ -0,0 +1,51 @@
+#include "wand/tile_pool.hpp"
+
+#include <numeric>
+#include <stdexcept>
+
+using Microsoft::WRL::ComPtr;
+
+namespace wand {
+auto TilePool::Allocate() -> std::optional<UINT> {
+  if (free_tiles_.empty()) {
+    return std::nullopt;
+  }
+
+  auto const tile{free_tiles_.back()};
+  free_tiles_.pop_back();
+  return tile;
+}
+
+
+auto TilePool::Release(UINT const tile) -> void {
+  if (tile >= tile_count_) {
+    throw std::runtime_error{"Failed to release tile: the tile is out of the range of the pool."};
+  }
+
+  free_tiles_.emplace_back(tile);
+}
+
+
+auto TilePool::GetFreeTileCount() const -> UINT {
+  return static_cast<UINT>(free_tiles_.size());
+}
+
+
+auto TilePool::GetTileCount() const -> UINT {
+  return tile_count_;
+}
+
+
+auto TilePool::GetHeapTileOffset() const -> UINT {
+  return static_cast<UINT>(allocation_->GetOffset() / D3D12_TILED_RESOURCE_TILE_SIZE_IN_BYTES);
+}
+
+
+TilePool::TilePool(ComPtr<D3D12MA::Allocation> allocation, UINT const tile_count) :
+  allocation_{std::move(allocation)},
+  free_tiles_(tile_count),
+  tile_count_{tile_count} {
+  // Hand out tiles in ascending order.
+  std::iota(free_tiles_.rbegin(), free_tiles_.rend(), UINT{0});
+}
+}
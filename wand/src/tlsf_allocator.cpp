@@ -0,0 +1,240 @@
+#include "wand/tlsf_allocator.hpp"
+
+#include <bit>
+#include <stdexcept>
+
+#include "wand/util.hpp"
+
+namespace wand::details {
+TlsfAllocator::TlsfAllocator(UINT64 const size) :
+  size_{size},
+  free_size_{size} {
+  for (auto& list : free_lists_) {
+    list.fill(kNullBlock);
+  }
+
+  if (size > 0) {
+    InsertFreeBlock(CreateBlock(0, size));
+  }
+}
+
+
+auto TlsfAllocator::Allocate(UINT64 const size, UINT64 const alignment) -> std::optional<UINT64> {
+  if (size == 0 || alignment == 0 || !std::has_single_bit(alignment)) {
+    throw std::runtime_error{"Failed to allocate from TLSF allocator: invalid size or alignment."};
+  }
+
+  // Any block of the padded size can fit the aligned allocation.
+  auto const padded_size{size + alignment - 1};
+
+  if (padded_size < size || padded_size > free_size_) {
+    return std::nullopt;
+  }
+
+  auto const block{FindFreeBlock(MapSearch(padded_size))};
+
+  if (block == kNullBlock) {
+    return std::nullopt;
+  }
+
+  RemoveFreeBlock(block);
+
+  auto allocated_block{block};
+
+  if (auto const padding{AlignUp(blocks_[block].offset, alignment) - blocks_[block].offset}; padding > 0) {
+    // The padding in front stays free. The previous physical block is allocated, otherwise they would have been merged.
+    allocated_block = SplitBlock(block, padding);
+    InsertFreeBlock(block);
+  }
+
+  if (blocks_[allocated_block].size > size) {
+    InsertFreeBlock(SplitBlock(allocated_block, size));
+  }
+
+  blocks_[allocated_block].free = false;
+  free_size_ -= size;
+  allocated_blocks_.emplace(blocks_[allocated_block].offset, allocated_block);
+  return blocks_[allocated_block].offset;
+}
+
+
+auto TlsfAllocator::Free(UINT64 const offset) -> void {
+  auto const it{allocated_blocks_.find(offset)};
+
+  if (it == allocated_blocks_.end()) {
+    throw std::runtime_error{"Failed to free TLSF allocation: no allocation at the offset."};
+  }
+
+  auto block{it->second};
+  allocated_blocks_.erase(it);
+
+  blocks_[block].free = true;
+  free_size_ += blocks_[block].size;
+
+  if (auto const prev{blocks_[block].prev_physical}; prev != kNullBlock && blocks_[prev].free) {
+    RemoveFreeBlock(prev);
+    MergeBlocks(prev, block);
+    block = prev;
+  }
+
+  if (auto const next{blocks_[block].next_physical}; next != kNullBlock && blocks_[next].free) {
+    RemoveFreeBlock(next);
+    MergeBlocks(block, next);
+  }
+
+  InsertFreeBlock(block);
+}
+
+
+auto TlsfAllocator::GetSize() const -> UINT64 {
+  return size_;
+}
+
+
+auto TlsfAllocator::GetFreeSize() const -> UINT64 {
+  return free_size_;
+}
+
+
+auto TlsfAllocator::MapInsert(UINT64 const size) -> ListIndex {
+  // Small sizes map linearly into the first list.
+  if (size < kSecondLevelCount) {
+    return ListIndex{0, static_cast<std::uint32_t>(size)};
+  }
+
+  auto const msb{static_cast<std::uint32_t>(std::bit_width(size) - 1)};
+  return ListIndex{
+    msb - kSecondLevelCountLog2 + 1,
+    static_cast<std::uint32_t>(size >> (msb - kSecondLevelCountLog2)) ^ kSecondLevelCount
+  };
+}
+
+
+auto TlsfAllocator::MapSearch(UINT64 const size) -> ListIndex {
+  if (size < kSecondLevelCount) {
+    return MapInsert(size);
+  }
+
+  // Rounding up to the next list skips the lists that contain blocks smaller than the size.
+  auto const msb{static_cast<std::uint32_t>(std::bit_width(size) - 1)};
+  auto const round{(UINT64{1} << (msb - kSecondLevelCountLog2)) - 1};
+  return MapInsert(size + round > size ? size + round : size);
+}
+
+
+auto TlsfAllocator::FindFreeBlock(ListIndex const idx) const -> std::uint32_t {
+  if (idx.first_level >= kFirstLevelCount) {
+    return kNullBlock;
+  }
+
+  auto first_level{idx.first_level};
+  auto second_level_bitmap{second_level_bitmaps_[first_level] & (~0u << idx.second_level)};
+
+  if (second_level_bitmap == 0) {
+    auto const first_level_bitmap{
+      first_level + 1 < 64 ? first_level_bitmap_ & (~std::uint64_t{0} << (first_level + 1)) : 0
+    };
+
+    if (first_level_bitmap == 0) {
+      return kNullBlock;
+    }
+
+    first_level = static_cast<std::uint32_t>(std::countr_zero(first_level_bitmap));
+    second_level_bitmap = second_level_bitmaps_[first_level];
+  }
+
+  return free_lists_[first_level][std::countr_zero(second_level_bitmap)];
+}
+
+
+auto TlsfAllocator::InsertFreeBlock(std::uint32_t const block) -> void {
+  auto const [first_level, second_level]{MapInsert(blocks_[block].size)};
+  auto& head{free_lists_[first_level][second_level]};
+
+  blocks_[block].free = true;
+  blocks_[block].prev_free = kNullBlock;
+  blocks_[block].next_free = head;
+
+  if (head != kNullBlock) {
+    blocks_[head].prev_free = block;
+  }
+
+  head = block;
+  first_level_bitmap_ |= std::uint64_t{1} << first_level;
+  second_level_bitmaps_[first_level] |= 1u << second_level;
+}
+
+
+auto TlsfAllocator::RemoveFreeBlock(std::uint32_t const block) -> void {
+  auto const [first_level, second_level]{MapInsert(blocks_[block].size)};
+  auto const prev{blocks_[block].prev_free};
+  auto const next{blocks_[block].next_free};
+
+  if (prev != kNullBlock) {
+    blocks_[prev].next_free = next;
+  } else {
+    free_lists_[first_level][second_level] = next;
+  }
+
+  if (next != kNullBlock) {
+    blocks_[next].prev_free = prev;
+  }
+
+  if (free_lists_[first_level][second_level] == kNullBlock) {
+    second_level_bitmaps_[first_level] &= ~(1u << second_level);
+
+    if (second_level_bitmaps_[first_level] == 0) {
+      first_level_bitmap_ &= ~(std::uint64_t{1} << first_level);
+    }
+  }
+}
+
+
+auto TlsfAllocator::SplitBlock(std::uint32_t const block, UINT64 const size) -> std::uint32_t {
+  auto const remainder{CreateBlock(blocks_[block].offset + size, blocks_[block].size - size)};
+  auto const next{blocks_[block].next_physical};
+
+  blocks_[remainder].prev_physical = block;
+  blocks_[remainder].next_physical = next;
+
+  if (next != kNullBlock) {
+    blocks_[next].prev_physical = remainder;
+  }
+
+  blocks_[block].next_physical = remainder;
+  blocks_[block].size = size;
+  return remainder;
+}
+
+
+auto TlsfAllocator::MergeBlocks(std::uint32_t const block, std::uint32_t const next) -> void {
+  blocks_[block].size += blocks_[next].size;
+  blocks_[block].next_physical = blocks_[next].next_physical;
+
+  if (blocks_[next].next_physical != kNullBlock) {
+    blocks_[blocks_[next].next_physical].prev_physical = block;
+  }
+
+  DestroyBlock(next);
+}
+
+
+auto TlsfAllocator::CreateBlock(UINT64 const offset, UINT64 const size) -> std::uint32_t {
+  Block const block{offset, size, kNullBlock, kNullBlock, kNullBlock, kNullBlock, true};
+
+  if (!unused_blocks_.empty()) {
+    auto const idx{unused_blocks_.back()};
+    unused_blocks_.pop_back();
+    blocks_[idx] = block;
+    return idx;
+  }
+
+  blocks_.emplace_back(block);
+  return static_cast<std::uint32_t>(blocks_.size() - 1);
+}
+
+
+auto TlsfAllocator::DestroyBlock(std::uint32_t const block) -> void {
+  unused_blocks_.emplace_back(block);
+}
+}
@@ -0,0 +1,81 @@
+#include "wand/transient_resource_heap.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+#include "wand/util.hpp"
+
+namespace wand {
+namespace details {
+auto PackTransientAllocations(std::span<TransientAllocation> const allocations) -> UINT64 {
+  // Placing the largest allocations first leaves the smaller ones to fill the gaps.
+  std::vector<std::size_t> order(allocations.size());
+  std::iota(order.begin(), order.end(), std::size_t{0});
+  std::ranges::stable_sort(order, [allocations](std::size_t const lhs, std::size_t const rhs) {
+    return allocations[lhs].size > allocations[rhs].size;
+  });
+
+  std::vector<std::pair<UINT64, UINT64>> occupied_ranges;
+  UINT64 required_size{0};
+
+  for (std::size_t i{0}; i < order.size(); i++) {
+    auto& allocation{allocations[order[i]]};
+
+    occupied_ranges.clear();
+
+    for (std::size_t j{0}; j < i; j++) {
+      if (auto const& placed{allocations[order[j]]};
+        placed.first_pass <= allocation.last_pass && allocation.first_pass <= placed.last_pass) {
+        occupied_ranges.emplace_back(placed.offset, placed.offset + placed.size);
+      }
+    }
+
+    std::ranges::sort(occupied_ranges);
+
+    // Lowest offset that fits before the next occupied range.
+    UINT64 offset{0};
+
+    for (auto const& [begin, end] : occupied_ranges) {
+      if (offset + allocation.size <= begin) {
+        break;
+      }
+
+      offset = std::max(offset, AlignUp(end, allocation.alignment));
+    }
+
+    allocation.offset = offset;
+    required_size = std::max(required_size, offset + allocation.size);
+  }
+
+  return required_size;
+}
+}
+
+
+auto TransientResourceHeap::GetBuffer(UINT const idx) const -> Buffer const& {
+  return *buffers_.at(idx);
+}
+
+
+auto TransientResourceHeap::GetTexture(UINT const idx) const -> Texture const& {
+  return *textures_.at(idx);
+}
+
+
+auto TransientResourceHeap::GetSize() const -> UINT64 {
+  return size_;
+}
+
+
+TransientResourceHeap::TransientResourceHeap(std::vector<SharedDeviceChildHandle<Buffer>> buffers,
+                                             std::vector<UINT> buffer_first_passes,
+                                             std::vector<SharedDeviceChildHandle<Texture>> textures,
+                                             std::vector<UINT> texture_first_passes, UINT64 const size) :
+  buffers_{std::move(buffers)},
+  buffer_first_passes_{std::move(buffer_first_passes)},
+  textures_{std::move(textures)},
+  texture_first_passes_{std::move(texture_first_passes)},
+  size_{size} {
+}
+}
@@ -0,0 +1,121 @@
+#include "wand/upload_queue.hpp"
+
+#include "wand/wand.hpp"
+
+namespace wand {
+auto UploadTicket::GetSubmission() const -> UINT64 {
+  return submission_->load(std::memory_order_acquire);
+}
+
+
+auto UploadTicket::IsSubmitted() const -> bool {
+  return GetSubmission() != 0;
+}
+
+
+UploadTicket::UploadTicket(std::shared_ptr<std::atomic<UINT64>> submission) :
+  submission_{std::move(submission)} {
+}
+
+
+UploadQueue::~UploadQueue() {
+  if (submit_thread_.joinable()) {
+    submit_thread_.request_stop();
+    submit_thread_.join();
+  }
+
+  for (auto job{TakeJobs()}; job;) {
+    auto const next{job->next};
+    delete job;
+    job = next;
+  }
+}
+
+
+auto UploadQueue::EnqueueBufferUpload(SharedDeviceChildHandle<Buffer> staging, UINT64 const staging_offset,
+                                      Buffer const& dst, UINT64 const dst_offset,
+                                      UINT64 const size) -> UploadTicket {
+  return Enqueue(new details::UploadJob{
+    std::move(staging), staging_offset, &dst, dst_offset, size, nullptr, 0, {},
+    std::make_shared<std::atomic<UINT64>>(0), nullptr
+  });
+}
+
+
+auto UploadQueue::EnqueueTextureUpload(SharedDeviceChildHandle<Buffer> staging,
+                                       D3D12_PLACED_SUBRESOURCE_FOOTPRINT const& footprint, Texture const& dst,
+                                       UINT const dst_subresource) -> UploadTicket {
+  return Enqueue(new details::UploadJob{
+    std::move(staging), 0, nullptr, 0, 0, &dst, dst_subresource, footprint,
+    std::make_shared<std::atomic<UINT64>>(0), nullptr
+  });
+}
+
+
+auto UploadQueue::GetDesc() const -> UploadQueueDesc const& {
+  return desc_;
+}
+
+
+UploadQueue::UploadQueue(GraphicsDevice& device, UploadQueueDesc const& desc) :
+  device_{&device},
+  desc_{desc} {
+  if (desc_.dedicated_thread) {
+    submit_thread_ = std::jthread{
+      [this](std::stop_token const& stop_token) {
+        RunSubmitThread(stop_token);
+      }
+    };
+  }
+}
+
+
+auto UploadQueue::Enqueue(details::UploadJob* const job) -> UploadTicket {
+  UploadTicket ticket{job->submission};
+
+  job->next = head_.load(std::memory_order_relaxed);
+  while (!head_.compare_exchange_weak(job->next, job, std::memory_order_release, std::memory_order_relaxed)) {}
+
+  pending_job_count_.fetch_add(1, std::memory_order_release);
+  pending_job_count_.notify_one();
+
+  return ticket;
+}
+
+
+auto UploadQueue::TakeJobs() -> details::UploadJob* {
+  pending_job_count_.store(0, std::memory_order_relaxed);
+
+  // The stack holds the most recent job first, reverse it to submit in enqueue order.
+  details::UploadJob* jobs{nullptr};
+
+  for (auto job{head_.exchange(nullptr, std::memory_order_acquire)}; job;) {
+    auto const next{job->next};
+    job->next = jobs;
+    jobs = job;
+    job = next;
+  }
+
+  return jobs;
+}
+
+
+auto UploadQueue::RunSubmitThread(std::stop_token const& stop_token) -> void {
+  std::stop_callback const wake{
+    stop_token, [this] {
+      pending_job_count_.fetch_add(1, std::memory_order_release);
+      pending_job_count_.notify_one();
+    }
+  };
+
+  while (true) {
+    pending_job_count_.wait(0, std::memory_order_acquire);
+
+    if (stop_token.stop_requested()) {
+      return;
+    }
+
+    device_->SubmitUploads(*this);
+  }
+}
+}
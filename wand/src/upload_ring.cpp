@@ -0,0 +1,84 @@
+#include "wand/upload_ring.hpp"
+
+#include <stdexcept>
+
+#include "wand/util.hpp"
+
+namespace wand {
+auto UploadRing::BeginFrame() -> void {
+  if (auto const& frame{frames_[frame_idx_]}; frame.fence) {
+    frame.fence->Wait(frame.completion_val);
+  }
+
+  frame_offset_ = 0;
+  frame_constant_buffer_count_ = 0;
+}
+
+
+auto UploadRing::EndFrame(Fence const& fence, UINT64 const completion_value) -> void {
+  frames_[frame_idx_] = {&fence, completion_value};
+  frame_idx_ = (frame_idx_ + 1) % desc_.frame_count;
+}
+
+
+auto UploadRing::Allocate(UINT64 const size, UINT64 const alignment) -> UploadAllocation {
+  auto offset{frame_offset_.load()};
+  UINT64 aligned_offset;
+
+  do {
+    aligned_offset = AlignUp(offset, alignment);
+
+    if (aligned_offset + size > desc_.frame_size) {
+      throw std::runtime_error{"Failed to allocate from upload ring: the region of the frame is full."};
+    }
+  } while (!frame_offset_.compare_exchange_weak(offset, aligned_offset + size));
+
+  auto const buffer_offset{frame_idx_ * desc_.frame_size + aligned_offset};
+
+  return UploadAllocation{
+    .cpu_data = buffer_->GetMappedData().subspan(buffer_offset, size),
+    .gpu_address = buffer_->GetGpuVirtualAddress() + buffer_offset, .buffer = buffer_.get(),
+    .offset = buffer_offset, .constant_buffer = std::nullopt
+  };
+}
+
+
+auto UploadRing::AllocateConstantBuffer(UINT64 const size) -> UploadAllocation {
+  auto const aligned_size{AlignUp<UINT64>(size, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT)};
+  auto allocation{Allocate(aligned_size, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT)};
+  allocation.cpu_data = allocation.cpu_data.first(size);
+
+  // The descriptor is only claimed once the memory is allocated, failed allocations must not use up descriptors.
+  auto cbv_idx{frame_constant_buffer_count_.load()};
+
+  do {
+    if (cbv_idx >= desc_.constant_buffers_per_frame) {
+      throw std::runtime_error{"Failed to allocate constant buffer from upload ring: the frame is out of descriptors."};
+    }
+  } while (!frame_constant_buffer_count_.compare_exchange_weak(cbv_idx, cbv_idx + 1));
+
+  auto const cbv{constant_buffers_[frame_idx_ * desc_.constant_buffers_per_frame + cbv_idx]};
+  D3D12_CONSTANT_BUFFER_VIEW_DESC const cbv_desc{allocation.gpu_address, static_cast<UINT>(aligned_size)};
+  device_->CreateConstantBufferView(&cbv_desc, res_desc_heap_->GetDescriptorCpuHandle(cbv));
+  allocation.constant_buffer = cbv;
+
+  return allocation;
+}
+
+
+auto UploadRing::GetBuffer() const -> Buffer const& {
+  return *buffer_;
+}
+
+
+UploadRing::UploadRing(SharedDeviceChildHandle<Buffer> buffer, ID3D12Device& device,
+                       details::DescriptorHeap& res_desc_heap, std::vector<UINT> constant_buffers,
+                       UploadRingDesc const& desc) :
+  buffer_{std::move(buffer)},
+  device_{&device},
+  res_desc_heap_{&res_desc_heap},
+  constant_buffers_{std::move(constant_buffers)},
+  frames_(desc.frame_count, details::UploadRingFrame{nullptr, 0}),
+  desc_{desc} {
+}
+}
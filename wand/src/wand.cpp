@@ -5,14 +5,21 @@
 #include <algorithm>
 #include <array>
 #include <bit>
+#include <chrono>
 #include <cmath>
 #include <iterator>
+#include <limits>
+#include <numeric>
 #include <stdexcept>
 #include <string_view>
+#include <thread>
+#include <tuple>
 #include <utility>
 #include <vector>
 
 #include "wand/format.hpp"
+#include "wand/mapped_file.hpp"
+#include "wand/memory_copy.hpp"
 #include "wand/util.hpp"
 
 using Microsoft::WRL::ComPtr;
@@ -30,9 +37,40 @@ UINT const GraphicsDevice::rtv_heap_size_{1'000'000};
 UINT const GraphicsDevice::dsv_heap_size_{1'000'000};
 UINT const GraphicsDevice::res_desc_heap_size_{1'000'000};
 UINT const GraphicsDevice::sampler_heap_size_{2048};
+UINT64 const GraphicsDevice::streaming_chunk_size_{8 * 1024 * 1024};
+UINT const GraphicsDevice::streaming_chunk_count_{8};
+UINT64 const GraphicsDevice::buffer_page_size_{1024 * 1024};
 
 
 namespace {
+// Returns nothing if the offsets the views of the buffer can address are not all multiples of a power of two.
+auto GetSubAllocationAlignment(BufferDesc const& desc) -> std::optional<UINT64> {
+  // Buffers without views are only copied, their offsets have to be valid texture copy footprint offsets.
+  if (!desc.constant_buffer && !desc.shader_resource && !desc.unordered_access) {
+    return D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT;
+  }
+
+  // Structured views address the buffer in elements.
+  auto const structured{(desc.shader_resource || desc.unordered_access) && desc.stride > 1};
+
+  if (structured && !std::has_single_bit(desc.stride)) {
+    return std::nullopt;
+  }
+
+  UINT64 alignment{D3D12_RAW_UAV_SRV_BYTE_ALIGNMENT};
+
+  if (desc.constant_buffer) {
+    alignment = std::max<UINT64>(alignment, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+  }
+
+  if (structured) {
+    alignment = std::max<UINT64>(alignment, desc.stride);
+  }
+
+  return alignment;
+}
+
+
 auto AsD3d12Desc(BufferDesc const& desc) -> D3D12_RESOURCE_DESC1 {
   auto flags{D3D12_RESOURCE_FLAG_NONE};
 
@@ -87,7 +125,8 @@ auto AsD3d12Desc(TextureDesc const& desc) -> D3D12_RESOURCE_DESC1 {
 }
 
 
-GraphicsDevice::GraphicsDevice(bool const enable_debug, bool const use_sw_rendering) {
+GraphicsDevice::GraphicsDevice(bool const enable_debug, bool const use_sw_rendering,
+                               std::filesystem::path const& pipeline_cache_path) {
   if (enable_debug) {
     ComPtr<ID3D12Debug6> debug;
     ThrowIfFailed(D3D12GetDebugInterface(IID_PPV_ARGS(&debug)), "Failed to get D3D12 debug interface.");
@@ -192,10 +231,22 @@ GraphicsDevice::GraphicsDevice(bool const enable_debug, bool const use_sw_render
                 "Failed to create sampler heap.");
   sampler_heap_ = std::make_unique<details::DescriptorHeap>(std::move(sampler_heap), *device_.Get());
 
-  D3D12_COMMAND_QUEUE_DESC constexpr queue_desc{
-    D3D12_COMMAND_LIST_TYPE_DIRECT, D3D12_COMMAND_QUEUE_PRIORITY_NORMAL, D3D12_COMMAND_QUEUE_FLAG_NONE, 0
-  };
-  ThrowIfFailed(device_->CreateCommandQueue(&queue_desc, IID_PPV_ARGS(&queue_)), "Failed to create command queue.");
+  for (std::size_t i{0}; i < kQueueTypeCount; i++) {
+    D3D12_COMMAND_QUEUE_DESC const queue_desc{
+      details::AsD3d12CommandListType(static_cast<QueueType>(i)), D3D12_COMMAND_QUEUE_PRIORITY_NORMAL,
+      D3D12_COMMAND_QUEUE_FLAG_NONE, 0
+    };
+    ThrowIfFailed(device_->CreateCommandQueue(&queue_desc, IID_PPV_ARGS(&queues_[i].queue)),
+                  "Failed to create command queue.");
+    queues_[i].fence = CreateFence(0);
+  }
+
+  residency_fence_ = CreateFence(0);
+  residency_manager_ = std::make_unique<details::ResidencyManager>();
+
+  if (!pipeline_cache_path.empty()) {
+    pipeline_library_ = std::make_unique<details::PipelineLibrary>(*device_.Get(), *adapter.Get(), pipeline_cache_path);
+  }
 
   if (BOOL allow_tearing; SUCCEEDED(
     factory_->CheckFeatureSupport(DXGI_FEATURE_PRESENT_ALLOW_TEARING, &allow_tearing, sizeof(allow_tearing)
@@ -203,20 +254,22 @@ GraphicsDevice::GraphicsDevice(bool const enable_debug, bool const use_sw_render
     swap_chain_flags_ |= DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING;
     present_flags_ |= DXGI_PRESENT_ALLOW_TEARING;
   }
-
-  idle_fence_ = CreateFence(0);
-  execute_barrier_fence_ = CreateFence(0);
 }
 
 
 auto GraphicsDevice::CreateBuffer(BufferDesc const& desc,
-                                  CpuAccess const cpu_access) -> SharedDeviceChildHandle<Buffer> {
+                                  CpuAccess const cpu_access,
+                                  MemoryPool const* const pool) -> SharedDeviceChildHandle<Buffer> {
+  if (!pool && desc.size <= buffer_sub_allocation_threshold_) {
+    if (auto const alignment{GetSubAllocationAlignment(desc)}) {
+      return CreateSubAllocatedBuffer(desc, cpu_access, *alignment);
+    }
+  }
+
   ComPtr<D3D12MA::Allocation> allocation;
   ComPtr<ID3D12Resource2> resource;
 
-  D3D12MA::ALLOCATION_DESC const alloc_desc{
-    D3D12MA::ALLOCATION_FLAG_NONE, MakeHeapType(cpu_access), D3D12_HEAP_FLAG_NONE, nullptr, nullptr
-  };
+  auto const alloc_desc{MakeAllocationDesc(cpu_access, pool)};
 
   auto const res_desc{AsD3d12Desc(desc)};
 
@@ -227,12 +280,14 @@ auto GraphicsDevice::CreateBuffer(BufferDesc const& desc,
   UINT srv;
   UINT uav;
 
-  CreateBufferViews(*resource.Get(), desc, cbv, srv, uav);
+  CreateBufferViews(*resource.Get(), 0, desc, cbv, srv, uav);
 
   global_resource_states_.Record(resource.Get(), {.layout = D3D12_BARRIER_LAYOUT_UNDEFINED});
+  TrackMemoryCategory(allocation.Get(), resource.Get(), MemoryCategory::kBuffer, true);
+  RegisterResidency(allocation.Get(), resource.Get());
 
   return SharedDeviceChildHandle<Buffer>{
-    new Buffer{std::move(allocation), std::move(resource), cbv, srv, uav, desc},
+    new Buffer{std::move(allocation), std::move(resource), cbv, srv, uav, desc, cpu_access, 0, nullptr},
     DeviceChildDeleter<Buffer>{*this}
   };
 }
@@ -240,7 +295,8 @@ auto GraphicsDevice::CreateBuffer(BufferDesc const& desc,
 
 auto GraphicsDevice::CreateTexture(TextureDesc const& desc,
                                    CpuAccess const cpu_access,
-                                   D3D12_CLEAR_VALUE const* clear_value) -> SharedDeviceChildHandle<Texture> {
+                                   D3D12_CLEAR_VALUE const* clear_value,
+                                   MemoryPool const* const pool) -> SharedDeviceChildHandle<Texture> {
   ComPtr<D3D12MA::Allocation> allocation;
   ComPtr<ID3D12Resource2> resource;
 
@@ -249,9 +305,7 @@ auto GraphicsDevice::CreateTexture(TextureDesc const& desc,
   // If a depth format is specified, we have to determine the typeless resource format.
   res_desc.Format = MakeDepthTypeless(desc.format);
 
-  D3D12MA::ALLOCATION_DESC const alloc_desc{
-    D3D12MA::ALLOCATION_FLAG_NONE, MakeHeapType(cpu_access), D3D12_HEAP_FLAG_NONE, nullptr, nullptr
-  };
+  auto const alloc_desc{MakeAllocationDesc(cpu_access, pool)};
 
   constexpr auto initial_layout{D3D12_BARRIER_LAYOUT_UNDEFINED};
 
@@ -266,9 +320,16 @@ auto GraphicsDevice::CreateTexture(TextureDesc const& desc,
   CreateTextureViews(*resource.Get(), desc, dsvs, rtvs, srv, uav);
 
   global_resource_states_.Record(resource.Get(), {.layout = initial_layout});
+  auto const category{
+    desc.render_target || desc.depth_stencil ? MemoryCategory::kRenderTarget : MemoryCategory::kTexture
+  };
+  TrackMemoryCategory(allocation.Get(), resource.Get(), category, true);
+  RegisterResidency(allocation.Get(), resource.Get());
 
   return SharedDeviceChildHandle<Texture>{
-    new Texture{std::move(allocation), std::move(resource), std::move(dsvs), std::move(rtvs), srv, uav, desc},
+    new Texture{
+      std::move(allocation), std::move(resource), std::move(dsvs), std::move(rtvs), srv, uav, desc, clear_value
+    },
     DeviceChildDeleter<Texture>{*this}
   };
 }
@@ -277,94 +338,102 @@ auto GraphicsDevice::CreateTexture(TextureDesc const& desc,
 auto GraphicsDevice::CreatePipelineState(PipelineDesc const& desc,
                                          std::uint8_t const num_32_bit_params) -> SharedDeviceChildHandle<
   PipelineState> {
-  auto root_signature{root_signatures_.Get(num_32_bit_params)};
-
-  if (!root_signature) {
-    std::array<CD3DX12_ROOT_PARAMETER1, 2> root_params;
-    root_params[0].InitAsConstants(num_32_bit_params, 0, 0, D3D12_SHADER_VISIBILITY_ALL);
-    // 2 params: base vertex and base instance. Make sure this aligns with the shader code!
-    root_params[1].InitAsConstants(2, 1, 0, D3D12_SHADER_VISIBILITY_VERTEX);
+  auto root_signature{GetOrCreateRootSignature(num_32_bit_params)};
+  auto pipeline_state{CompilePipelineState(desc, num_32_bit_params, *root_signature.Get())};
 
-    D3D12_VERSIONED_ROOT_SIGNATURE_DESC const root_signature_desc{
-      .Version = D3D_ROOT_SIGNATURE_VERSION_1_1,
-      .Desc_1_1 = {
-        static_cast<UINT>(root_params.size()), root_params.data(), 0, nullptr,
-        D3D12_ROOT_SIGNATURE_FLAG_CBV_SRV_UAV_HEAP_DIRECTLY_INDEXED |
-        D3D12_ROOT_SIGNATURE_FLAG_SAMPLER_HEAP_DIRECTLY_INDEXED
-      }
-    };
+  return SharedDeviceChildHandle<PipelineState>{
+    new PipelineState{
+      std::move(root_signature), std::move(pipeline_state), nullptr, num_32_bit_params, desc.cs.BytecodeLength != 0,
+      desc.depth_stencil_state.DepthEnable && desc.depth_stencil_state.DepthWriteMask != D3D12_DEPTH_WRITE_MASK_ZERO
+    },
+    DeviceChildDeleter<PipelineState>{*this}
+  };
+}
 
-    ComPtr<ID3DBlob> root_signature_blob;
-    ComPtr<ID3DBlob> error_blob;
 
-    ThrowIfFailed(D3D12SerializeVersionedRootSignature(&root_signature_desc, &root_signature_blob, &error_blob),
-                  "Failed to serialize root signature.");
-    ThrowIfFailed(device_->CreateRootSignature(0, root_signature_blob->GetBufferPointer(),
-                                               root_signature_blob->GetBufferSize(), IID_PPV_ARGS(&root_signature)),
-                  "Failed to create root signature.");
+auto GraphicsDevice::CreatePipelineStateAsync(PipelineDesc const& desc, std::uint8_t const num_32_bit_params,
+                                              SharedDeviceChildHandle<PipelineState> fallback) ->
+  SharedDeviceChildHandle<PipelineState> {
+  auto const is_compute{desc.cs.BytecodeLength != 0};
 
-    root_signature = root_signatures_.Add(num_32_bit_params, std::move(root_signature));
+  if (fallback && (fallback->num_params_ != num_32_bit_params || fallback->is_compute_ != is_compute)) {
+    throw std::runtime_error{
+      "Failed to create pipeline state: the fallback has a different parameter count or pipeline type."
+    };
   }
 
-  ComPtr<ID3D12PipelineState> pipeline_state;
-
-  CD3DX12_PIPELINE_STATE_STREAM2 pso_desc;
-  pso_desc.Flags = D3D12_PIPELINE_STATE_FLAG_NONE;
-  pso_desc.NodeMask = 0;
-  pso_desc.pRootSignature = root_signature.Get();
-  pso_desc.PrimitiveTopologyType = desc.primitive_topology_type;
-  pso_desc.VS = desc.vs;
-  pso_desc.GS = desc.gs;
-  pso_desc.StreamOutput = desc.stream_output;
-  pso_desc.HS = desc.hs;
-  pso_desc.DS = desc.ds;
-  pso_desc.PS = desc.ps;
-  pso_desc.AS = desc.as;
-  pso_desc.MS = desc.ms;
-  pso_desc.CS = desc.cs;
-  pso_desc.BlendState = desc.blend_state;
-  pso_desc.DepthStencilState = desc.depth_stencil_state;
-  pso_desc.DSVFormat = desc.ds_format;
-  pso_desc.RasterizerState = desc.rasterizer_state;
-  pso_desc.RTVFormats = desc.rt_formats;
-  pso_desc.SampleDesc = desc.sample_desc;
-  pso_desc.SampleMask = desc.sample_mask;
-  pso_desc.ViewInstancingDesc = desc.view_instancing_desc;
-
-  D3D12_PIPELINE_STATE_STREAM_DESC const stream_desc{sizeof(pso_desc), &pso_desc};
-  ThrowIfFailed(device_->CreatePipelineState(&stream_desc, IID_PPV_ARGS(&pipeline_state)),
-                "Failed to create pipeline state.");
+  std::call_once(pipeline_compiler_init_, [this] {
+    pipeline_compiler_ = std::make_unique<details::ThreadPool>(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+  });
 
-  return SharedDeviceChildHandle<PipelineState>{
+  SharedDeviceChildHandle<PipelineState> pipeline_state{
     new PipelineState{
-      std::move(root_signature), std::move(pipeline_state), num_32_bit_params, desc.cs.BytecodeLength != 0,
+      GetOrCreateRootSignature(num_32_bit_params), nullptr, std::move(fallback), num_32_bit_params, is_compute,
       desc.depth_stencil_state.DepthEnable && desc.depth_stencil_state.DepthWriteMask != D3D12_DEPTH_WRITE_MASK_ZERO
     },
     DeviceChildDeleter<PipelineState>{*this}
   };
+
+  // The job keeps the pipeline state alive in case it is released before compilation finishes.
+  pipeline_compiler_->Submit([this, desc, num_32_bit_params, pipeline_state] {
+    try {
+      pipeline_state->pipeline_state_ = CompilePipelineState(desc, num_32_bit_params,
+                                                             *pipeline_state->root_signature_.Get());
+      pipeline_state->status_.store(details::PipelineStateStatus::kReady, std::memory_order_release);
+    } catch (std::exception const& e) {
+      pipeline_state->error_ = e.what();
+      pipeline_state->status_.store(details::PipelineStateStatus::kFailed, std::memory_order_release);
+    }
+
+    pipeline_state->status_.notify_all();
+  });
+
+  return pipeline_state;
 }
 
 
-auto GraphicsDevice::CreateCommandList() -> SharedDeviceChildHandle<CommandList> {
+auto GraphicsDevice::CreateCommandList(QueueType const queue_type) -> SharedDeviceChildHandle<CommandList> {
+  auto const type{details::AsD3d12CommandListType(queue_type)};
+
   ComPtr<ID3D12CommandAllocator> allocator;
-  ThrowIfFailed(device_->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&allocator)),
+  ThrowIfFailed(device_->CreateCommandAllocator(type, IID_PPV_ARGS(&allocator)),
                 "Failed to create command allocator.");
 
   ComPtr<ID3D12GraphicsCommandList7> cmd_list;
   ThrowIfFailed(
-    device_->CreateCommandList1(0, D3D12_COMMAND_LIST_TYPE_DIRECT, D3D12_COMMAND_LIST_FLAG_NONE,
-                                IID_PPV_ARGS(&cmd_list)), "Failed to create command list.");
+    device_->CreateCommandList1(0, type, D3D12_COMMAND_LIST_FLAG_NONE, IID_PPV_ARGS(&cmd_list)),
+    "Failed to create command list.");
 
   return SharedDeviceChildHandle<CommandList>{
     new CommandList{
       std::move(allocator), std::move(cmd_list), dsv_heap_.get(), rtv_heap_.get(), res_desc_heap_.get(),
-      sampler_heap_.get(), &root_signatures_
+      sampler_heap_.get(), &root_signatures_, &command_signatures_, queue_type
     },
     DeviceChildDeleter<CommandList>{*this}
   };
 }
 
 
+auto GraphicsDevice::CreateBundle() -> SharedDeviceChildHandle<Bundle> {
+  ComPtr<ID3D12CommandAllocator> allocator;
+  ThrowIfFailed(device_->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_BUNDLE, IID_PPV_ARGS(&allocator)),
+                "Failed to create bundle allocator.");
+
+  ComPtr<ID3D12GraphicsCommandList7> cmd_list;
+  ThrowIfFailed(
+    device_->CreateCommandList1(0, D3D12_COMMAND_LIST_TYPE_BUNDLE, D3D12_COMMAND_LIST_FLAG_NONE,
+                                IID_PPV_ARGS(&cmd_list)), "Failed to create bundle.");
+
+  return SharedDeviceChildHandle<Bundle>{
+    new Bundle{
+      std::move(allocator), std::move(cmd_list), res_desc_heap_.get(), sampler_heap_.get(), &root_signatures_,
+      &command_signatures_
+    },
+    DeviceChildDeleter<Bundle>{*this}
+  };
+}
+
+
 auto GraphicsDevice::CreateFence(UINT64 const initial_value) -> SharedDeviceChildHandle<Fence> {
   ComPtr<ID3D12Fence1> fence;
   ThrowIfFailed(device_->CreateFence(initial_value, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence)),
@@ -384,7 +453,8 @@ auto GraphicsDevice::CreateSwapChain(SwapChainDesc const& desc,
 
   ComPtr<IDXGISwapChain1> swap_chain1;
   ThrowIfFailed(
-    factory_->CreateSwapChainForHwnd(queue_.Get(), window_handle, &dxgi_desc, nullptr, nullptr, &swap_chain1),
+    factory_->CreateSwapChainForHwnd(GetQueue(QueueType::kGraphics).queue.Get(), window_handle, &dxgi_desc, nullptr,
+      nullptr, &swap_chain1),
     "Failed to create swap chain.");
 
   ComPtr<IDXGISwapChain4> swap_chain4;
@@ -406,6 +476,181 @@ auto GraphicsDevice::CreateSampler(D3D12_SAMPLER_DESC const& desc) -> UniqueSamp
 }
 
 
+auto GraphicsDevice::CreateUploadRing(UploadRingDesc const& desc) -> SharedDeviceChildHandle<UploadRing> {
+  if (desc.frame_count == 0) {
+    throw std::runtime_error{"Failed to create upload ring: frame count must be greater than zero."};
+  }
+
+  auto ring_desc{desc};
+  // Aligning the regions keeps allocation alignments relative to the start of the buffer valid in every frame.
+  ring_desc.frame_size = AlignUp<UINT64>(desc.frame_size, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT);
+
+  auto buffer{
+    CreateBuffer(BufferDesc{ring_desc.frame_size * ring_desc.frame_count, 1, false, false, false}, CpuAccess::kWrite)
+  };
+
+  auto const constant_buffer_count{
+    static_cast<std::size_t>(ring_desc.constant_buffers_per_frame) * ring_desc.frame_count
+  };
+  std::vector<UINT> constant_buffers;
+  constant_buffers.reserve(constant_buffer_count);
+
+  // Descriptors are only counted once allocated so that a failing allocation releases exactly the preceding ones.
+  try {
+    while (constant_buffers.size() < constant_buffer_count) {
+      constant_buffers.emplace_back(res_desc_heap_->Allocate());
+    }
+  } catch (...) {
+    std::ranges::for_each(constant_buffers, [this](UINT const cbv) {
+      res_desc_heap_->Release(cbv);
+    });
+    throw;
+  }
+
+  return SharedDeviceChildHandle<UploadRing>{
+    new UploadRing{std::move(buffer), *device_.Get(), *res_desc_heap_, std::move(constant_buffers), ring_desc},
+    DeviceChildDeleter<UploadRing>{*this}
+  };
+}
+
+
+auto GraphicsDevice::CreateMemoryPool(MemoryPoolDesc const& desc) -> SharedDeviceChildHandle<MemoryPool> {
+  if (desc.max_block_count != 0 && desc.min_block_count > desc.max_block_count) {
+    throw std::runtime_error{"Failed to create memory pool: minimum block count exceeds maximum block count."};
+  }
+
+  D3D12MA::POOL_DESC pool_desc{};
+  pool_desc.Flags = desc.linear ? D3D12MA::POOL_FLAG_ALGORITHM_LINEAR : D3D12MA::POOL_FLAG_NONE;
+  pool_desc.HeapProperties = CD3DX12_HEAP_PROPERTIES{MakeHeapType(desc.cpu_access)};
+  pool_desc.HeapFlags = desc.heap_flags;
+  pool_desc.BlockSize = desc.block_size;
+  pool_desc.MinBlockCount = desc.min_block_count;
+  pool_desc.MaxBlockCount = desc.max_block_count;
+
+  ComPtr<D3D12MA::Pool> pool;
+  ThrowIfFailed(allocator_->CreatePool(&pool_desc, &pool), "Failed to create memory pool.");
+
+  return SharedDeviceChildHandle<MemoryPool>{
+    new MemoryPool{std::move(pool), desc},
+    DeviceChildDeleter<MemoryPool>{*this}
+  };
+}
+
+
+auto GraphicsDevice::CreateReservedBuffer(BufferDesc const& desc) -> SharedDeviceChildHandle<Buffer> {
+  if (supported_features_.TiledResourcesTier() == D3D12_TILED_RESOURCES_TIER_NOT_SUPPORTED) {
+    throw std::runtime_error{"Failed to create reserved buffer: tiled resources are not supported."};
+  }
+
+  auto const res_desc{AsD3d12Desc(desc)};
+  ComPtr<ID3D12Resource2> resource;
+
+  // D3D12_RESOURCE_DESC1 only extends D3D12_RESOURCE_DESC with members at the end.
+  ThrowIfFailed(device_->CreateReservedResource2(reinterpret_cast<D3D12_RESOURCE_DESC const*>(&res_desc),
+                                                 D3D12_BARRIER_LAYOUT_UNDEFINED, nullptr, nullptr, 0, nullptr,
+                                                 IID_PPV_ARGS(&resource)), "Failed to create reserved buffer.");
+
+  UINT cbv;
+  UINT srv;
+  UINT uav;
+
+  CreateBufferViews(*resource.Get(), 0, desc, cbv, srv, uav);
+
+  global_resource_states_.Record(resource.Get(), {.layout = D3D12_BARRIER_LAYOUT_UNDEFINED});
+
+  return SharedDeviceChildHandle<Buffer>{
+    new Buffer{nullptr, std::move(resource), cbv, srv, uav, desc, CpuAccess::kNone, 0, nullptr},
+    DeviceChildDeleter<Buffer>{*this}
+  };
+}
+
+
+auto GraphicsDevice::CreateReservedTexture(TextureDesc const& desc,
+                                           D3D12_CLEAR_VALUE const* clear_value) -> SharedDeviceChildHandle<Texture> {
+  if (supported_features_.TiledResourcesTier() == D3D12_TILED_RESOURCES_TIER_NOT_SUPPORTED) {
+    throw std::runtime_error{"Failed to create reserved texture: tiled resources are not supported."};
+  }
+
+  auto res_desc{AsD3d12Desc(desc)};
+  res_desc.Format = MakeDepthTypeless(desc.format);
+  // Reserved textures must use the swizzle that lays out tiles in 64KB blocks.
+  res_desc.Layout = D3D12_TEXTURE_LAYOUT_64KB_UNDEFINED_SWIZZLE;
+
+  constexpr auto initial_layout{D3D12_BARRIER_LAYOUT_UNDEFINED};
+  ComPtr<ID3D12Resource2> resource;
+
+  // D3D12_RESOURCE_DESC1 only extends D3D12_RESOURCE_DESC with members at the end.
+  ThrowIfFailed(device_->CreateReservedResource2(reinterpret_cast<D3D12_RESOURCE_DESC const*>(&res_desc),
+                                                 initial_layout, clear_value, nullptr, 0, nullptr,
+                                                 IID_PPV_ARGS(&resource)), "Failed to create reserved texture.");
+
+  std::vector<UINT> dsvs;
+  std::vector<UINT> rtvs;
+  std::optional<UINT> srv;
+  std::optional<UINT> uav;
+
+  CreateTextureViews(*resource.Get(), desc, dsvs, rtvs, srv, uav);
+
+  global_resource_states_.Record(resource.Get(), {.layout = initial_layout});
+
+  return SharedDeviceChildHandle<Texture>{
+    new Texture{nullptr, std::move(resource), std::move(dsvs), std::move(rtvs), srv, uav, desc, clear_value},
+    DeviceChildDeleter<Texture>{*this}
+  };
+}
+
+
+auto GraphicsDevice::CreateTilePool(TilePoolDesc const& desc) -> SharedDeviceChildHandle<TilePool> {
+  D3D12MA::ALLOCATION_DESC const alloc_desc{
+    MakeAllocationFlags(), D3D12_HEAP_TYPE_DEFAULT, desc.heap_flags, nullptr, nullptr
+  };
+
+  D3D12_RESOURCE_ALLOCATION_INFO const alloc_info{
+    static_cast<UINT64>(desc.tile_count) * D3D12_TILED_RESOURCE_TILE_SIZE_IN_BYTES,
+    D3D12_TILED_RESOURCE_TILE_SIZE_IN_BYTES
+  };
+
+  ComPtr<D3D12MA::Allocation> allocation;
+  ThrowIfFailed(allocator_->AllocateMemory(&alloc_desc, &alloc_info, &allocation),
+                "Failed to allocate memory for tile pool.");
+
+  // Reserved resources aren't tracked, so the memory they map is never evicted.
+  residency_manager_->Pin(allocation->GetHeap(), allocation->GetHeap()->GetDesc().SizeInBytes);
+
+  return SharedDeviceChildHandle<TilePool>{
+    new TilePool{std::move(allocation), desc.tile_count}, DeviceChildDeleter<TilePool>{*this}
+  };
+}
+
+
+auto GraphicsDevice::CreateGeometryPool(GeometryPoolDesc const& desc) -> SharedDeviceChildHandle<GeometryPool> {
+  // Raw views cover the buffer in 4 byte units.
+  auto buffer{
+    CreateBuffer(BufferDesc{AlignUp<UINT64>(desc.size, 4), 1, false, true, desc.unordered_access}, CpuAccess::kNone)
+  };
+
+  return SharedDeviceChildHandle<GeometryPool>{
+    new GeometryPool{std::move(buffer)}, DeviceChildDeleter<GeometryPool>{*this}
+  };
+}
+
+
+auto GraphicsDevice::CreateUploadQueue(UploadQueueDesc const& desc) -> SharedDeviceChildHandle<UploadQueue> {
+  return SharedDeviceChildHandle<UploadQueue>{new UploadQueue{*this, desc}, DeviceChildDeleter<UploadQueue>{*this}};
+}
+
+
+auto GraphicsDevice::CreateResourcePool(ResourcePoolDesc const& desc) -> SharedDeviceChildHandle<ResourcePool> {
+  if (desc.retention_frame_count < desc.frames_in_flight) {
+    throw std::runtime_error{
+      "Failed to create resource pool: the retention period is shorter than the frames in flight."
+    };
+  }
+
+  return SharedDeviceChildHandle<ResourcePool>{new ResourcePool{*this, desc}, DeviceChildDeleter<ResourcePool>{*this}};
+}
+
+
 auto GraphicsDevice::CreateAliasingResources(std::span<BufferDesc const> const buffer_descs,
                                              std::span<AliasedTextureCreateInfo const> const texture_infos,
                                              CpuAccess cpu_access,
@@ -439,7 +684,7 @@ auto GraphicsDevice::CreateAliasingResources(std::span<BufferDesc const> const b
 
   if (allocator_->GetD3D12Options().ResourceHeapTier > D3D12_RESOURCE_HEAP_TIER_1) {
     D3D12MA::ALLOCATION_DESC alloc_desc{
-      D3D12MA::ALLOCATION_FLAG_NONE, heap_type, D3D12_HEAP_FLAG_NONE, nullptr, nullptr
+      MakeAllocationFlags(), heap_type, D3D12_HEAP_FLAG_NONE, nullptr, nullptr
     };
 
     if (buf_alloc_info.SizeInBytes == 0) {
@@ -467,7 +712,7 @@ auto GraphicsDevice::CreateAliasingResources(std::span<BufferDesc const> const b
   } else {
     if (buf_alloc_info.SizeInBytes > 0) {
       D3D12MA::ALLOCATION_DESC const buf_alloc_desc{
-        D3D12MA::ALLOCATION_FLAG_NONE, heap_type, D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS, nullptr, nullptr
+        MakeAllocationFlags(), heap_type, D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS, nullptr, nullptr
       };
 
       ThrowIfFailed(allocator_->AllocateMemory(&buf_alloc_desc, &buf_alloc_info, &buf_alloc),
@@ -476,7 +721,7 @@ auto GraphicsDevice::CreateAliasingResources(std::span<BufferDesc const> const b
 
     if (rt_ds_alloc_info.SizeInBytes > 0) {
       D3D12MA::ALLOCATION_DESC const rt_ds_alloc_desc{
-        D3D12MA::ALLOCATION_FLAG_NONE, heap_type, D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES, nullptr, nullptr
+        MakeAllocationFlags(), heap_type, D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES, nullptr, nullptr
       };
 
       ThrowIfFailed(allocator_->AllocateMemory(&rt_ds_alloc_desc, &rt_ds_alloc_info, &rt_ds_alloc),
@@ -485,7 +730,7 @@ auto GraphicsDevice::CreateAliasingResources(std::span<BufferDesc const> const b
 
     if (non_rt_ds_alloc_info.SizeInBytes > 0) {
       D3D12MA::ALLOCATION_DESC const non_rt_ds_alloc_desc{
-        D3D12MA::ALLOCATION_FLAG_NONE, heap_type, D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES, nullptr, nullptr
+        MakeAllocationFlags(), heap_type, D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES, nullptr, nullptr
       };
 
       ThrowIfFailed(allocator_->AllocateMemory(&non_rt_ds_alloc_desc, &non_rt_ds_alloc_info, &non_rt_ds_alloc),
@@ -495,98 +740,321 @@ auto GraphicsDevice::CreateAliasingResources(std::span<BufferDesc const> const b
 
   if (buffers) {
     for (auto const& buf_desc : buffer_descs) {
-      auto const desc{AsD3d12Desc(buf_desc)};
-      ComPtr<ID3D12Resource2> resource;
-
-      ThrowIfFailed(allocator_->CreateAliasingResource2(buf_alloc.Get(), 0, &desc, D3D12_BARRIER_LAYOUT_UNDEFINED,
-                                                        nullptr, 0, nullptr, IID_PPV_ARGS(&resource)),
-                    "Failed to create aliasing buffer.");
-
-      UINT cbv;
-      UINT srv;
-      UINT uav;
-      CreateBufferViews(*resource.Get(), buf_desc, cbv, srv, uav);
-      buffers->emplace_back(new Buffer{buf_alloc, std::move(resource), cbv, srv, uav, buf_desc},
-                            DeviceChildDeleter<Buffer>{*this});
+      buffers->emplace_back(CreateAliasingBuffer(buf_alloc, 0, buf_desc, cpu_access));
     }
   }
 
   if (textures) {
     for (auto const& info : texture_infos) {
-      auto const desc{AsD3d12Desc(info.desc)};
-
-      auto& alloc{info.desc.render_target || info.desc.depth_stencil ? rt_ds_alloc : non_rt_ds_alloc};
-
-      ComPtr<ID3D12Resource2> resource;
-      ThrowIfFailed(allocator_->CreateAliasingResource2(alloc.Get(), 0, &desc, info.initial_layout, info.clear_value, 0,
-                                                        nullptr, IID_PPV_ARGS(&resource)),
-                    "Failed to create aliasing texture.");
-
-      std::vector<UINT> dsvs;
-      std::vector<UINT> rtvs;
-      std::optional<UINT> srv;
-      std::optional<UINT> uav;
-      CreateTextureViews(*resource.Get(), info.desc, dsvs, rtvs, srv, uav);
-      textures->emplace_back(new Texture{
-                               alloc, std::move(resource), std::move(dsvs), std::move(rtvs), srv, uav, info.desc
-                             }, DeviceChildDeleter<Texture>{*this});
+      auto const& alloc{info.desc.render_target || info.desc.depth_stencil ? rt_ds_alloc : non_rt_ds_alloc};
+      textures->emplace_back(CreateAliasingTexture(alloc, 0, info));
     }
   }
 }
 
 
-auto GraphicsDevice::DestroyBuffer(Buffer const* const buffer) const -> void {
-  if (buffer) {
-    if (buffer->cbv_) {
-      res_desc_heap_->Release(*buffer->cbv_);
-    }
+auto GraphicsDevice::CreatePlacedResources(std::span<PlacedBufferCreateInfo const> const buffer_infos,
+                                           std::span<PlacedTextureCreateInfo const> const texture_infos,
+                                           CpuAccess const cpu_access,
+                                           std::vector<SharedDeviceChildHandle<Buffer>>* const buffers,
+                                           std::vector<SharedDeviceChildHandle<Texture>>* const textures) -> void {
+  std::vector<UINT64> buffer_offsets;
+  std::vector<UINT64> texture_offsets;
+  D3D12_RESOURCE_ALLOCATION_INFO alloc_info{0, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT};
+  UINT64 cursor{0};
 
-    if (buffer->srv_) {
-      res_desc_heap_->Release(*buffer->srv_);
-    }
+  auto const place{
+    [this, &alloc_info, &cursor](D3D12_RESOURCE_DESC1 const& desc, std::optional<UINT64> const& offset) {
+      auto const res_alloc_info{device_->GetResourceAllocationInfo2(0, 1, &desc, nullptr)};
+      auto const res_offset{offset.value_or(AlignUp(cursor, res_alloc_info.Alignment))};
 
-    if (buffer->uav_) {
-      res_desc_heap_->Release(*buffer->uav_);
+      if (res_offset % res_alloc_info.Alignment != 0) {
+        throw std::runtime_error{"Failed to create placed resources: a resource offset is not properly aligned."};
+      }
+
+      cursor = std::max(cursor, res_offset + res_alloc_info.SizeInBytes);
+      alloc_info.SizeInBytes = std::max(alloc_info.SizeInBytes, cursor);
+      alloc_info.Alignment = std::max(alloc_info.Alignment, res_alloc_info.Alignment);
+      return res_offset;
     }
+  };
 
-    delete buffer;
+  bool has_buffers{false};
+  bool has_rt_ds_textures{false};
+  bool has_non_rt_ds_textures{false};
+
+  for (auto const& info : buffer_infos) {
+    buffer_offsets.emplace_back(place(AsD3d12Desc(info.desc), info.offset));
+    has_buffers = true;
   }
-}
 
+  for (auto const& info : texture_infos) {
+    auto desc{AsD3d12Desc(info.desc)};
+    desc.Format = MakeDepthTypeless(info.desc.format);
+    texture_offsets.emplace_back(place(desc, info.offset));
+    (info.desc.render_target || info.desc.depth_stencil ? has_rt_ds_textures : has_non_rt_ds_textures) = true;
+  }
 
-auto GraphicsDevice::DestroyTexture(Texture const* const texture) const -> void {
-  if (texture) {
-    std::ranges::for_each(texture->dsvs_, [this](UINT const dsv) {
-      dsv_heap_->Release(dsv);
-    });
+  if (alloc_info.SizeInBytes == 0) {
+    return;
+  }
 
-    std::ranges::for_each(texture->rtvs_, [this](UINT const rtv) {
-      rtv_heap_->Release(rtv);
-    });
+  D3D12MA::ALLOCATION_DESC alloc_desc{
+    MakeAllocationFlags(), MakeHeapType(cpu_access), D3D12_HEAP_FLAG_NONE, nullptr, nullptr
+  };
 
-    if (texture->srv_) {
-      res_desc_heap_->Release(*texture->srv_);
+  if (allocator_->GetD3D12Options().ResourceHeapTier > D3D12_RESOURCE_HEAP_TIER_1) {
+    if (!has_buffers) {
+      alloc_desc.ExtraHeapFlags |= D3D12_HEAP_FLAG_DENY_BUFFERS;
     }
 
-    if (texture->uav_) {
-      res_desc_heap_->Release(*texture->uav_);
+    if (!has_rt_ds_textures) {
+      alloc_desc.ExtraHeapFlags |= D3D12_HEAP_FLAG_DENY_RT_DS_TEXTURES;
     }
 
-    delete texture;
+    if (!has_non_rt_ds_textures) {
+      alloc_desc.ExtraHeapFlags |= D3D12_HEAP_FLAG_DENY_NON_RT_DS_TEXTURES;
+    }
+  } else if (has_buffers + has_rt_ds_textures + has_non_rt_ds_textures > 1) {
+    throw std::runtime_error{
+      "Failed to create placed resources: resource heap tier 1 doesn't support mixing resource categories."
+    };
+  } else {
+    alloc_desc.ExtraHeapFlags = has_buffers
+                                  ? D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS
+                                  : has_rt_ds_textures
+                                  ? D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES
+                                  : D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES;
   }
-}
 
+  ComPtr<D3D12MA::Allocation> allocation;
+  ThrowIfFailed(allocator_->AllocateMemory(&alloc_desc, &alloc_info, &allocation),
+                "Failed to allocate memory for placed resources.");
+
+  if (buffers) {
+    for (std::size_t i{0}; i < buffer_infos.size(); i++) {
+      buffers->emplace_back(CreateAliasingBuffer(allocation, buffer_offsets[i], buffer_infos[i].desc, cpu_access));
+    }
+  }
+
+  if (textures) {
+    for (std::size_t i{0}; i < texture_infos.size(); i++) {
+      auto const& info{texture_infos[i]};
+      textures->emplace_back(CreateAliasingTexture(allocation, texture_offsets[i],
+                                                   AliasedTextureCreateInfo{
+                                                     info.desc, info.initial_layout, info.clear_value
+                                                   }));
+    }
+  }
+}
+
+
+auto GraphicsDevice::CreateTransientResourceHeap(std::span<TransientBufferDesc const> const buffer_descs,
+                                                 std::span<TransientTextureDesc const> const texture_descs) ->
+  SharedDeviceChildHandle<TransientResourceHeap> {
+  // Resource heap tier 1 can't mix buffers, RT/DS textures and other textures in a heap, so each is packed apart.
+  enum class Category : std::uint8_t { kBuffer = 0, kRtDsTexture = 1, kNonRtDsTexture = 2 };
+
+  auto const separate_categories{allocator_->GetD3D12Options().ResourceHeapTier == D3D12_RESOURCE_HEAP_TIER_1};
+  auto const get_category_idx{
+    [separate_categories](Category const category) {
+      return separate_categories ? static_cast<std::size_t>(category) : std::size_t{0};
+    }
+  };
+
+  std::array<std::vector<details::TransientAllocation>, 3> allocations;
+
+  auto const add_allocation{
+    [this, &allocations, &get_category_idx](D3D12_RESOURCE_DESC1 const& desc, Category const category,
+                                             UINT const first_pass, UINT const last_pass) {
+      if (first_pass > last_pass) {
+        throw std::runtime_error{"Failed to create transient resource heap: a resource is used after its last pass."};
+      }
+
+      auto const alloc_info{device_->GetResourceAllocationInfo2(0, 1, &desc, nullptr)};
+      allocations[get_category_idx(category)].emplace_back(details::TransientAllocation{
+        alloc_info.SizeInBytes, alloc_info.Alignment, first_pass, last_pass, 0
+      });
+    }
+  };
+
+  for (auto const& buffer_desc : buffer_descs) {
+    add_allocation(AsD3d12Desc(buffer_desc.desc), Category::kBuffer, buffer_desc.first_pass, buffer_desc.last_pass);
+  }
+
+  for (auto const& texture_desc : texture_descs) {
+    auto desc{AsD3d12Desc(texture_desc.desc)};
+    desc.Format = MakeDepthTypeless(texture_desc.desc.format);
+    add_allocation(desc, texture_desc.desc.render_target || texture_desc.desc.depth_stencil
+                           ? Category::kRtDsTexture
+                           : Category::kNonRtDsTexture, texture_desc.first_pass, texture_desc.last_pass);
+  }
+
+  constexpr std::array category_heap_flags{
+    D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS, D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES,
+    D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES
+  };
+
+  std::array<ComPtr<D3D12MA::Allocation>, 3> memory;
+  UINT64 total_size{0};
+
+  for (std::size_t i{0}; i < allocations.size(); i++) {
+    if (allocations[i].empty()) {
+      continue;
+    }
+
+    D3D12_RESOURCE_ALLOCATION_INFO const alloc_info{
+      details::PackTransientAllocations(allocations[i]),
+      std::ranges::max(allocations[i], {}, &details::TransientAllocation::alignment).alignment
+    };
+
+    D3D12MA::ALLOCATION_DESC const alloc_desc{
+      MakeAllocationFlags(), D3D12_HEAP_TYPE_DEFAULT,
+      separate_categories ? category_heap_flags[i] : D3D12_HEAP_FLAG_NONE, nullptr, nullptr
+    };
+
+    ThrowIfFailed(allocator_->AllocateMemory(&alloc_desc, &alloc_info, &memory[i]),
+                  "Failed to allocate memory for transient resources.");
+    total_size += alloc_info.SizeInBytes;
+  }
+
+  std::array<std::size_t, 3> next_allocation_indices{};
+  auto const place{
+    [&](Category const category) {
+      auto const category_idx{get_category_idx(category)};
+      return std::pair{memory[category_idx], allocations[category_idx][next_allocation_indices[category_idx]++].offset};
+    }
+  };
+
+  std::vector<SharedDeviceChildHandle<Buffer>> buffers;
+  std::vector<UINT> buffer_first_passes;
+
+  for (auto const& buffer_desc : buffer_descs) {
+    auto const [alloc, offset]{place(Category::kBuffer)};
+    buffers.emplace_back(CreateAliasingBuffer(alloc, offset, buffer_desc.desc, CpuAccess::kNone));
+    buffer_first_passes.emplace_back(buffer_desc.first_pass);
+  }
+
+  std::vector<SharedDeviceChildHandle<Texture>> textures;
+  std::vector<UINT> texture_first_passes;
+
+  for (auto const& texture_desc : texture_descs) {
+    auto const [alloc, offset]{
+      place(texture_desc.desc.render_target || texture_desc.desc.depth_stencil
+              ? Category::kRtDsTexture
+              : Category::kNonRtDsTexture)
+    };
+
+    // Contents are discarded when the lifetime of the texture begins, so the initial layout doesn't matter.
+    AliasedTextureCreateInfo const info{
+      texture_desc.desc, D3D12_BARRIER_LAYOUT_UNDEFINED, const_cast<D3D12_CLEAR_VALUE*>(texture_desc.clear_value)
+    };
+    textures.emplace_back(CreateAliasingTexture(alloc, offset, info));
+    texture_first_passes.emplace_back(texture_desc.first_pass);
+  }
+
+  return SharedDeviceChildHandle<TransientResourceHeap>{
+    new TransientResourceHeap{
+      std::move(buffers), std::move(buffer_first_passes), std::move(textures), std::move(texture_first_passes),
+      total_size
+    },
+    DeviceChildDeleter<TransientResourceHeap>{*this}
+  };
+}
+
+
+auto GraphicsDevice::DestroyBuffer(Buffer const* const buffer) const -> void {
+  if (buffer) {
+    if (auto const page{buffer->page_}) {
+      std::scoped_lock const lock{buffer_page_mutex_};
+      page->allocator.Free(buffer->offset_);
+
+      // A single empty page of each kind is retained so that short-lived buffers don't recreate pages.
+      auto const is_empty_of_kind{
+        [page](std::unique_ptr<details::BufferPage> const& other) {
+          return other->cpu_access == page->cpu_access && other->flags == page->flags &&
+                 other->allocator.GetFreeSize() == buffer_page_size_;
+        }
+      };
+
+      if (page->allocator.GetFreeSize() == buffer_page_size_ &&
+          std::ranges::count_if(buffer_pages_, is_empty_of_kind) > 1) {
+        TrackMemoryCategory(page->allocation.Get(), page->resource.Get(), MemoryCategory::kBuffer, false);
+        UnregisterResidency(page->resource.Get());
+        std::erase_if(buffer_pages_, [page](std::unique_ptr<details::BufferPage> const& other) {
+          return other.get() == page;
+        });
+      }
+    }
+
+    TrackMemoryCategory(buffer->allocation_.Get(), buffer->resource_.Get(), MemoryCategory::kBuffer, false);
+
+    // Pages stay registered for the buffers still sub-allocated from them.
+    if (!buffer->page_) {
+      UnregisterResidency(buffer->resource_.Get());
+    }
+
+    if (buffer->cbv_) {
+      res_desc_heap_->Release(*buffer->cbv_);
+    }
+
+    if (buffer->srv_) {
+      res_desc_heap_->Release(*buffer->srv_);
+    }
+
+    if (buffer->uav_) {
+      res_desc_heap_->Release(*buffer->uav_);
+    }
+
+    delete buffer;
+  }
+}
+
+
+auto GraphicsDevice::DestroyTexture(Texture const* const texture) const -> void {
+  if (texture) {
+    TrackMemoryCategory(texture->allocation_.Get(), texture->resource_.Get(),
+                        texture->desc_.render_target || texture->desc_.depth_stencil
+                          ? MemoryCategory::kRenderTarget
+                          : MemoryCategory::kTexture, false);
+    UnregisterResidency(texture->resource_.Get());
+
+    std::ranges::for_each(texture->dsvs_, [this](UINT const dsv) {
+      dsv_heap_->Release(dsv);
+    });
+
+    std::ranges::for_each(texture->rtvs_, [this](UINT const rtv) {
+      rtv_heap_->Release(rtv);
+    });
+
+    if (texture->srv_) {
+      res_desc_heap_->Release(*texture->srv_);
+    }
+
+    if (texture->uav_) {
+      res_desc_heap_->Release(*texture->uav_);
+    }
+
+    delete texture;
+  }
+}
+
+
+auto GraphicsDevice::DestroyPipelineState(PipelineState const* const pipeline_state) const -> void {
+  delete pipeline_state;
+}
 
-auto GraphicsDevice::DestroyPipelineState(PipelineState const* const pipeline_state) const -> void {
-  delete pipeline_state;
-}
-
 
 auto GraphicsDevice::DestroyCommandList(CommandList const* const command_list) const -> void {
   delete command_list;
 }
 
 
+auto GraphicsDevice::DestroyBundle(Bundle const* const bundle) const -> void {
+  delete bundle;
+}
+
+
 auto GraphicsDevice::DestroyFence(Fence const* const fence) const -> void {
   delete fence;
 }
@@ -602,26 +1070,103 @@ auto GraphicsDevice::DestroySampler(UINT const sampler) const -> void {
 }
 
 
-auto GraphicsDevice::WaitFence(Fence const& fence, UINT64 const wait_value) const -> void {
-  ThrowIfFailed(queue_->Wait(fence.fence_.Get(), wait_value), "Failed to wait fence from GPU queue.");
+auto GraphicsDevice::DestroyUploadRing(UploadRing const* const upload_ring) const -> void {
+  if (upload_ring) {
+    std::ranges::for_each(upload_ring->constant_buffers_, [this](UINT const cbv) {
+      res_desc_heap_->Release(cbv);
+    });
+
+    delete upload_ring;
+  }
+}
+
+
+auto GraphicsDevice::DestroyTransientResourceHeap(TransientResourceHeap const* const transient_resource_heap) const ->
+  void {
+  delete transient_resource_heap;
 }
 
 
-auto GraphicsDevice::SignalFence(Fence& fence) const -> void {
-  auto const new_fence_val{fence.next_val_.load()};
-  ThrowIfFailed(queue_->Signal(fence.fence_.Get(), new_fence_val), "Failed to signal fence from GPU queue.");
-  fence.next_val_ = new_fence_val + 1;
+auto GraphicsDevice::DestroyTilePool(TilePool const* const tile_pool) const -> void {
+  if (tile_pool) {
+    if (auto const evicted{residency_manager_->Unpin(tile_pool->allocation_->GetHeap())}) {
+      MakeResidentOnRelease(*evicted);
+    }
+  }
+
+  delete tile_pool;
+}
+
+
+auto GraphicsDevice::DestroyGeometryPool(GeometryPool const* const geometry_pool) const -> void {
+  delete geometry_pool;
+}
+
+
+auto GraphicsDevice::DestroyUploadQueue(UploadQueue const* const upload_queue) const -> void {
+  delete upload_queue;
 }
 
 
-auto GraphicsDevice::ExecuteCommandLists(std::span<CommandList const> const cmd_lists) -> void {
+auto GraphicsDevice::DestroyResourcePool(ResourcePool const* const resource_pool) const -> void {
+  delete resource_pool;
+}
+
+
+auto GraphicsDevice::DestroyMemoryPool(MemoryPool const* const memory_pool) const -> void {
+  delete memory_pool;
+}
+
+
+auto GraphicsDevice::WaitFence(Fence const& fence, UINT64 const wait_value, QueueType const queue_type) -> void {
+  std::scoped_lock const lock{submit_mutex_};
+  // Work executed before the wait must not be held back by it.
+  FlushQueue(queue_type);
+  ThrowIfFailed(GetQueue(queue_type).queue->Wait(fence.fence_.Get(), wait_value),
+                "Failed to wait fence from GPU queue.");
+}
+
+
+auto GraphicsDevice::SignalFence(Fence& fence, QueueType const queue_type) -> void {
+  std::scoped_lock const lock{submit_mutex_};
+  FlushQueue(queue_type);
+  EnqueueSignal(*GetQueue(queue_type).queue.Get(), fence);
+}
+
+
+auto GraphicsDevice::ExecuteCommandLists(std::span<CommandList const> const cmd_lists,
+                                         QueueType const queue_type) -> UINT64 {
+  std::scoped_lock const lock{submit_mutex_};
+
+  details::QueueTransfer transfer;
+
+  for (auto const& cmd_list : cmd_lists) {
+    if (cmd_list.queue_type_ != queue_type) {
+      throw std::runtime_error{"Failed to execute command lists: command list type doesn't match the queue type."};
+    }
+
+    for (auto const& [res, state] : cmd_list.local_resource_states_) {
+      PrepareQueueTransfer(res, queue_type, transfer);
+    }
+  }
+
+  ExecuteQueueTransfer(transfer, queue_type);
+
+  auto& queue{GetQueue(queue_type)};
+  auto const fence_val{queue.fence->GetNextValue()};
+
   std::vector<D3D12_TEXTURE_BARRIER> pending_tex_barriers;
+  std::vector<ID3D12Pageable*> evicted_pageables;
 
   for (auto const& cmd_list : cmd_lists) {
     for (auto const& pending_barrier : cmd_list.pending_barriers_) {
       auto const global_state{global_resource_states_.Get(pending_barrier.resource)};
       auto layout_before{global_state ? global_state->layout : D3D12_BARRIER_LAYOUT_UNDEFINED};
 
+      if (layout_before == pending_barrier.layout) {
+        continue;
+      }
+
       pending_tex_barriers.emplace_back(D3D12_BARRIER_SYNC_NONE, D3D12_BARRIER_SYNC_NONE,
                                         D3D12_BARRIER_ACCESS_NO_ACCESS, D3D12_BARRIER_ACCESS_NO_ACCESS,
                                         layout_before, pending_barrier.layout, pending_barrier.resource,
@@ -633,37 +1178,99 @@ auto GraphicsDevice::ExecuteCommandLists(std::span<CommandList const> const cmd_
     }
 
     for (auto const& [res, state] : cmd_list.local_resource_states_) {
-      global_resource_states_.Record(res, {.layout = state.layout});
+      global_resource_states_.Record(res, {.layout = state.layout, .queue = queue_type, .queue_fence_val = fence_val});
+      residency_manager_->MarkUsed(res, queue_type, fence_val, evicted_pageables);
+    }
+
+    for (auto const res : cmd_list.used_resources_) {
+      residency_manager_->MarkUsed(res, queue_type, fence_val, evicted_pageables);
     }
   }
 
-  D3D12_BARRIER_GROUP const pending_barrier_group{
-    .Type = D3D12_BARRIER_TYPE_TEXTURE, .NumBarriers = ClampCast<UINT32>(pending_tex_barriers.size()),
-    .pTextureBarriers = pending_tex_barriers.data()
-  };
+  MakeResident(evicted_pageables, queue_type);
 
-  auto& pending_barrier_cmd{AcquirePendingBarrierCmdList()};
+  if (!pending_tex_barriers.empty()) {
+    D3D12_BARRIER_GROUP const pending_barrier_group{
+      .Type = D3D12_BARRIER_TYPE_TEXTURE, .NumBarriers = ClampCast<UINT32>(pending_tex_barriers.size()),
+      .pTextureBarriers = pending_tex_barriers.data()
+    };
+
+    auto& pending_barrier_cmd{AcquirePendingBarrierCmdList(queue_type)};
 
-  pending_barrier_cmd.Begin(nullptr);
-  pending_barrier_cmd.cmd_list_->Barrier(1, &pending_barrier_group);
-  pending_barrier_cmd.End();
-  queue_->ExecuteCommandLists(1,
-                              std::array{static_cast<ID3D12CommandList*>(pending_barrier_cmd.cmd_list_.Get())}.data());
-  SignalFence(*execute_barrier_fence_);
+    pending_barrier_cmd.Begin(nullptr);
+    pending_barrier_cmd.cmd_list_->Barrier(1, &pending_barrier_group);
+    pending_barrier_cmd.End();
+    queue.pending_cmd_lists.emplace_back(pending_barrier_cmd.cmd_list_.Get());
+  }
 
-  std::vector<ID3D12CommandList*> submit_list;
-  submit_list.reserve(cmd_lists.size());
-  std::ranges::transform(cmd_lists, std::back_inserter(submit_list), [](CommandList const& cmd_list) {
+  std::ranges::transform(cmd_lists, std::back_inserter(queue.pending_cmd_lists), [](CommandList const& cmd_list) {
     return cmd_list.cmd_list_.Get();
   });
-  queue_->ExecuteCommandLists(static_cast<UINT>(submit_list.size()), submit_list.data());
+
+  if (submit_mode_ == SubmitMode::kImmediate) {
+    FlushQueue(queue_type);
+  }
+
+  return fence_val;
+}
+
+
+auto GraphicsDevice::IsSubmissionComplete(QueueType const queue_type, UINT64 const submission) const -> bool {
+  return GetQueue(queue_type).fence->GetCompletedValue() >= submission;
+}
+
+
+auto GraphicsDevice::WaitSubmission(QueueType const queue_type, UINT64 const submission) -> void {
+  if (IsSubmissionComplete(queue_type, submission)) {
+    return;
+  }
+
+  // The submission might still be waiting for a deferred flush.
+  {
+    std::scoped_lock const lock{submit_mutex_};
+    FlushQueue(queue_type);
+  }
+
+  GetQueue(queue_type).fence->Wait(submission);
+}
+
+
+auto GraphicsDevice::WaitIdle() -> void {
+  std::scoped_lock const lock{submit_mutex_};
+
+  for (std::size_t i{0}; i < kQueueTypeCount; i++) {
+    FlushQueue(static_cast<QueueType>(i));
+    auto const fence_val{SignalQueue(static_cast<QueueType>(i))};
+    queues_[i].fence->Wait(fence_val);
+  }
+}
+
+
+auto GraphicsDevice::SavePipelineCache() -> void {
+  if (pipeline_library_) {
+    pipeline_library_->Save();
+  }
+}
+
+
+auto GraphicsDevice::SetSubmitMode(SubmitMode const mode) -> void {
+  std::scoped_lock const lock{submit_mutex_};
+  submit_mode_ = mode;
+
+  if (mode == SubmitMode::kImmediate) {
+    for (std::size_t i{0}; i < kQueueTypeCount; i++) {
+      FlushQueue(static_cast<QueueType>(i));
+    }
+  }
 }
 
 
-auto GraphicsDevice::WaitIdle() const -> void {
-  auto const fence_val{idle_fence_->GetNextValue()};
-  SignalFence(*idle_fence_);
-  idle_fence_->Wait(fence_val);
+auto GraphicsDevice::Flush() -> void {
+  std::scoped_lock const lock{submit_mutex_};
+
+  for (std::size_t i{0}; i < kQueueTypeCount; i++) {
+    FlushQueue(static_cast<QueueType>(i));
+  }
 }
 
 
@@ -676,12 +1283,29 @@ auto GraphicsDevice::ResizeSwapChain(SwapChain& swap_chain, UINT const width, UI
 
 
 auto GraphicsDevice::Present(SwapChain const& swap_chain) -> void {
+  // Callbacks may release resources, so they run before anything is locked.
+  NotifyBudgetCallbacks();
+
+  std::scoped_lock const lock{submit_mutex_};
+
+  EvictColdMemory();
+
   auto const cur_tex{swap_chain.GetCurrentTexture().resource_.Get()};
+
+  details::QueueTransfer transfer;
+  PrepareQueueTransfer(cur_tex, QueueType::kGraphics, transfer);
+  ExecuteQueueTransfer(transfer, QueueType::kGraphics);
+
   auto const state{global_resource_states_.Get(cur_tex)};
   auto const layout_before{state ? state->layout : D3D12_BARRIER_LAYOUT_UNDEFINED};
 
   if (!state || state->layout != D3D12_BARRIER_LAYOUT_PRESENT) {
-    global_resource_states_.Record(cur_tex, {.layout = D3D12_BARRIER_LAYOUT_PRESENT});
+    auto& queue{GetQueue(QueueType::kGraphics)};
+
+    global_resource_states_.Record(cur_tex, {
+                                     .layout = D3D12_BARRIER_LAYOUT_PRESENT, .queue = QueueType::kGraphics,
+                                     .queue_fence_val = queue.fence->GetNextValue()
+                                   });
 
     D3D12_TEXTURE_BARRIER const barrier{
       D3D12_BARRIER_SYNC_NONE, D3D12_BARRIER_SYNC_NONE,
@@ -699,13 +1323,16 @@ auto GraphicsDevice::Present(SwapChain const& swap_chain) -> void {
       .Type = D3D12_BARRIER_TYPE_TEXTURE, .NumBarriers = 1, .pTextureBarriers = &barrier
     };
 
-    auto& cmd_list{AcquirePendingBarrierCmdList()};
+    auto& cmd_list{AcquirePendingBarrierCmdList(QueueType::kGraphics)};
     cmd_list.Begin(nullptr);
     cmd_list.cmd_list_->Barrier(1, &barrier_group);
     cmd_list.End();
 
-    queue_->ExecuteCommandLists(1, std::array{static_cast<ID3D12CommandList*>(cmd_list.cmd_list_.Get())}.data());
-    SignalFence(*execute_barrier_fence_);
+    queue.pending_cmd_lists.emplace_back(cmd_list.cmd_list_.Get());
+  }
+
+  for (std::size_t i{0}; i < kQueueTypeCount; i++) {
+    FlushQueue(static_cast<QueueType>(i));
   }
 
   ThrowIfFailed(swap_chain.swap_chain_->Present(swap_chain.GetSyncInterval(), present_flags_),
@@ -713,340 +1340,1775 @@ auto GraphicsDevice::Present(SwapChain const& swap_chain) -> void {
 }
 
 
-auto GraphicsDevice::GetCopyableFootprints(TextureDesc const& desc, UINT const first_subresource,
-                                           UINT const subresource_count, UINT64 const base_offset,
-                                           D3D12_PLACED_SUBRESOURCE_FOOTPRINT* const layouts, UINT* const row_counts,
-                                           UINT64* const row_sizes, UINT64* const total_size) const -> void {
-  auto const tex_desc{AsD3d12Desc(desc)};
-  return device_->GetCopyableFootprints1(&tex_desc, first_subresource, subresource_count, base_offset, layouts,
-                                         row_counts, row_sizes, total_size);
-}
+auto GraphicsDevice::MapTiles(Resource const& resource, TilePool const& pool,
+                              std::span<TileRegionMapping const> const regions,
+                              QueueType const queue_type) -> UINT64 {
+  std::vector<D3D12_TILED_RESOURCE_COORDINATE> coordinates;
+  std::vector<D3D12_TILE_REGION_SIZE> sizes;
+  std::vector<UINT> heap_range_start_offsets;
+  auto const heap_tile_offset{pool.GetHeapTileOffset()};
 
+  for (auto const& region : regions) {
+    if (region.pool_tiles.size() != region.size.NumTiles) {
+      throw std::runtime_error{"Failed to map tiles: the number of pool tiles differs from the size of the region."};
+    }
 
-auto GraphicsDevice::SwapChainCreateTextures(SwapChain& swap_chain) -> void {
-  DXGI_SWAP_CHAIN_DESC1 desc;
-  ThrowIfFailed(swap_chain.swap_chain_->GetDesc1(&desc), "Failed to retrieve swap chain desc.");
+    coordinates.emplace_back(region.coordinate);
+    sizes.emplace_back(region.size);
 
-  TextureDesc const tex_desc{
-    TextureDimension::k2D, desc.Width, desc.Height, 1, 1, desc.Format, 1, false,
-    (desc.BufferUsage & DXGI_USAGE_RENDER_TARGET_OUTPUT) != 0, (desc.BufferUsage & DXGI_USAGE_SHADER_INPUT) != 0, false
-  };
+    // Ranges are consumed by the regions in order, so each pool tile becomes a single tile range.
+    for (auto const tile : region.pool_tiles) {
+      if (tile >= pool.GetTileCount()) {
+        throw std::runtime_error{"Failed to map tiles: a tile is out of the range of the pool."};
+      }
 
-  for (UINT i{0}; i < desc.BufferCount; i++) {
-    ComPtr<ID3D12Resource2> buf;
-    ThrowIfFailed(swap_chain.swap_chain_->GetBuffer(i, IID_PPV_ARGS(&buf)), "Failed to retrieve swap chain buffer.");
+      heap_range_start_offsets.emplace_back(heap_tile_offset + tile);
+    }
+  }
 
-    std::vector<UINT> dsvs;
-    std::vector<UINT> rtvs;
-    std::optional<UINT> srv;
-    std::optional<UINT> uav;
+  std::vector const range_flags(heap_range_start_offsets.size(), D3D12_TILE_RANGE_FLAG_NONE);
+  std::vector const range_tile_counts(heap_range_start_offsets.size(), UINT{1});
 
-    CreateTextureViews(*buf.Get(), tex_desc, dsvs, rtvs, srv, uav);
+  return UpdateTileMappings(*resource.resource_.Get(), coordinates, sizes, pool.allocation_->GetHeap(), range_flags,
+                            heap_range_start_offsets, range_tile_counts, queue_type);
+}
 
-    global_resource_states_.Record(buf.Get(), {.layout = D3D12_BARRIER_LAYOUT_COMMON});
 
-    swap_chain.textures_.emplace_back(new Texture{
-                                        nullptr, std::move(buf), {}, std::move(rtvs), srv,
-                                        kInvalidResourceIndex, tex_desc
-                                      }, DeviceChildDeleter<Texture>{*this});
+auto GraphicsDevice::UnmapTiles(Resource const& resource,
+                                std::span<D3D12_TILED_RESOURCE_COORDINATE const> const coordinates,
+                                std::span<D3D12_TILE_REGION_SIZE const> const sizes,
+                                QueueType const queue_type) -> UINT64 {
+  if (coordinates.size() != sizes.size()) {
+    throw std::runtime_error{"Failed to unmap tiles: the number of coordinates differs from the number of sizes."};
   }
+
+  // A single null range covers all regions.
+  constexpr std::array range_flags{D3D12_TILE_RANGE_FLAG_NULL};
+  constexpr std::array heap_range_start_offsets{UINT{0}};
+  std::array const range_tile_counts{
+    std::transform_reduce(sizes.begin(), sizes.end(), UINT{0}, std::plus{}, [](D3D12_TILE_REGION_SIZE const& size) {
+      return size.NumTiles;
+    })
+  };
+
+  return UpdateTileMappings(*resource.resource_.Get(), coordinates, sizes, nullptr, range_flags,
+                            heap_range_start_offsets, range_tile_counts, queue_type);
 }
 
 
-auto GraphicsDevice::CreateBufferViews(ID3D12Resource2& buffer, BufferDesc const& desc, UINT& cbv, UINT& srv,
-                                       UINT& uav) const -> void {
-  if (desc.constant_buffer) {
-    cbv = res_desc_heap_->Allocate();
-    D3D12_CONSTANT_BUFFER_VIEW_DESC const cbv_desc{buffer.GetGPUVirtualAddress(), static_cast<UINT>(desc.size)};
-    device_->CreateConstantBufferView(&cbv_desc, res_desc_heap_->GetDescriptorCpuHandle(cbv));
-  } else {
-    cbv = kInvalidResourceIndex;
+auto GraphicsDevice::UploadTexture(Texture const& texture, std::span<SubresourceData const> const subresources,
+                                   UINT const first_subresource) -> UINT64 {
+  TextureUploadDesc const upload{&texture, first_subresource, subresources};
+  return UploadTextures(std::span{&upload, 1});
+}
+
+
+auto GraphicsDevice::UploadTextures(std::span<TextureUploadDesc const> const uploads) -> UINT64 {
+  std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> footprints;
+  std::vector<UINT> row_counts;
+  std::vector<UINT64> row_sizes;
+  UINT64 staging_size{0};
+
+  for (auto const& upload : uploads) {
+    auto const desc{upload.texture->GetInternalResource()->GetDesc1()};
+    auto const subresource_count{static_cast<UINT>(upload.subresources.size())};
+    auto const first_footprint_idx{footprints.size()};
+
+    footprints.resize(first_footprint_idx + subresource_count);
+    row_counts.resize(first_footprint_idx + subresource_count);
+    row_sizes.resize(first_footprint_idx + subresource_count);
+
+    UINT64 upload_size;
+    device_->GetCopyableFootprints1(&desc, upload.first_subresource, subresource_count, 0,
+                                    footprints.data() + first_footprint_idx, row_counts.data() + first_footprint_idx,
+                                    row_sizes.data() + first_footprint_idx, &upload_size);
+
+    // Every texture gets its own properly aligned part of the staging buffer.
+    auto const base_offset{AlignUp<UINT64>(staging_size, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT)};
+
+    for (auto i{first_footprint_idx}; i < footprints.size(); i++) {
+      footprints[i].Offset += base_offset;
+    }
+
+    staging_size = base_offset + upload_size;
   }
 
-  if (desc.shader_resource) {
-    srv = res_desc_heap_->Allocate();
-    D3D12_SHADER_RESOURCE_VIEW_DESC const srv_desc{
-      .Format = desc.stride == 1 ? DXGI_FORMAT_R32_TYPELESS : DXGI_FORMAT_UNKNOWN,
-      .ViewDimension = D3D12_SRV_DIMENSION_BUFFER, .Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING,
-      .Buffer = {
-        0, static_cast<UINT>(desc.size / (desc.stride == 1 ? 4 : desc.stride)), desc.stride == 1 ? 0 : desc.stride,
-        desc.stride == 1 ? D3D12_BUFFER_SRV_FLAG_RAW : D3D12_BUFFER_SRV_FLAG_NONE
-      }
-    };
-    device_->CreateShaderResourceView(&buffer, &srv_desc, res_desc_heap_->GetDescriptorCpuHandle(srv));
-  } else {
-    srv = kInvalidResourceIndex;
+  if (staging_size == 0) {
+    return 0;
   }
 
-  if (desc.unordered_access) {
-    uav = res_desc_heap_->Allocate();
+  auto staging_buffer{CreateBuffer(BufferDesc{staging_size, 1, false, false, false}, CpuAccess::kWrite)};
+  auto const staging_data{staging_buffer->GetMappedData()};
+
+  std::size_t footprint_idx{0};
+
+  for (auto const& upload : uploads) {
+    for (auto const& subresource : upload.subresources) {
+      auto const& footprint{footprints[footprint_idx]};
+      auto const row_count{row_counts[footprint_idx]};
+      auto const row_size{row_sizes[footprint_idx]};
+      ++footprint_idx;
+
+      for (UINT z{0}; z < footprint.Footprint.Depth; z++) {
+        auto const dst_slice{
+          staging_data.data() + footprint.Offset + static_cast<UINT64>(z) * footprint.Footprint.RowPitch * row_count
+        };
+        auto const src_slice{static_cast<std::byte const*>(subresource.data) + z * subresource.slice_pitch};
+
+        // Tightly packed rows with matching pitch can be copied in one go.
+        if (subresource.row_pitch == footprint.Footprint.RowPitch && row_size == footprint.Footprint.RowPitch) {
+          details::StreamingCopy(dst_slice, src_slice, row_size * row_count);
+          continue;
+        }
+
+        for (UINT row{0}; row < row_count; row++) {
+          details::StreamingCopy(dst_slice + static_cast<UINT64>(row) * footprint.Footprint.RowPitch,
+                                 src_slice + row * subresource.row_pitch, row_size);
+        }
+      }
+    }
+  }
+
+  std::scoped_lock const lock{copy_mutex_};
+
+  auto& record{AcquireCopyRecord()};
+  auto& cmd_list{*record.cmd_list};
+
+  cmd_list.Begin(nullptr);
+
+  footprint_idx = 0;
+
+  for (auto const& upload : uploads) {
+    for (UINT i{0}; i < static_cast<UINT>(upload.subresources.size()); i++) {
+      cmd_list.CopyTextureRegion(*upload.texture, upload.first_subresource + i, 0, 0, 0, *staging_buffer,
+                                 footprints[footprint_idx]);
+      ++footprint_idx;
+    }
+  }
+
+  cmd_list.End();
+
+  return SubmitCopyRecord(record, {std::move(staging_buffer)});
+}
+
+
+auto GraphicsDevice::ReadbackBuffer(Buffer const& buffer, UINT64 const offset, UINT64 const size) -> Readback {
+  // The readback is described as a single row, whose pitch is 32 bits wide.
+  if (size > std::numeric_limits<UINT>::max()) {
+    throw std::runtime_error{"Failed to read back buffer: the size does not fit in a single row."};
+  }
+
+  std::scoped_lock const lock{copy_mutex_};
+
+  auto& record{AcquireCopyRecord()};
+  auto staging_buffer{AcquireReadbackBuffer(size)};
+  auto& cmd_list{*record.cmd_list};
+
+  cmd_list.Begin(nullptr);
+  cmd_list.CopyBufferRegion(*staging_buffer, 0, buffer, offset, size);
+  cmd_list.End();
+
+  auto const submission{SubmitCopyRecord(record, {staging_buffer})};
+
+  D3D12_PLACED_SUBRESOURCE_FOOTPRINT const footprint{
+    0, {DXGI_FORMAT_UNKNOWN, ClampCast<UINT>(size), 1, 1, ClampCast<UINT>(size)}
+  };
+
+  return Readback{
+    *this, std::move(staging_buffer), size, GetQueue(QueueType::kCopy).fence, submission, footprint
+  };
+}
+
+
+auto GraphicsDevice::ReadbackTexture(Texture const& texture, UINT const subresource) -> Readback {
+  auto const desc{texture.GetInternalResource()->GetDesc1()};
+  D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprint;
+  UINT64 size;
+  device_->GetCopyableFootprints1(&desc, subresource, 1, 0, &footprint, nullptr, nullptr, &size);
+
+  std::scoped_lock const lock{copy_mutex_};
+
+  auto& record{AcquireCopyRecord()};
+  auto staging_buffer{AcquireReadbackBuffer(size)};
+  auto& cmd_list{*record.cmd_list};
+
+  cmd_list.Begin(nullptr);
+  cmd_list.CopyTextureRegion(*staging_buffer, footprint, texture, subresource, nullptr);
+  cmd_list.End();
+
+  auto const submission{SubmitCopyRecord(record, {staging_buffer})};
+
+  return Readback{
+    *this, std::move(staging_buffer), size, GetQueue(QueueType::kCopy).fence, submission, footprint
+  };
+}
+
+
+auto GraphicsDevice::UploadGeometry(GeometryPool const& pool, GeometryAllocation const& allocation,
+                                    std::span<std::byte const> const data) -> UINT64 {
+  if (data.size() > allocation.size) {
+    throw std::runtime_error{"Failed to upload geometry: the data is larger than the allocation."};
+  }
+
+  return StreamBuffer(pool.GetBuffer(), allocation.offset, data);
+}
+
+
+auto GraphicsDevice::StreamBuffer(Buffer const& dst, UINT64 const dst_offset,
+                                  std::span<std::byte const> const src) -> UINT64 {
+  std::scoped_lock const lock{copy_mutex_};
+
+  UINT64 submission{0};
+
+  for (UINT64 offset{0}; offset < src.size();) {
+    auto& chunk{AcquireStreamingChunk()};
+    auto const size{std::min<UINT64>(src.size() - offset, streaming_chunk_size_)};
+    details::StreamingCopy(chunk.buffer->GetMappedData().data(), src.data() + offset, size);
+
+    auto& record{AcquireCopyRecord()};
+    record.cmd_list->Begin(nullptr);
+    record.cmd_list->CopyBufferRegion(dst, dst_offset + offset, *chunk.buffer, 0, size);
+    record.cmd_list->End();
+
+    submission = SubmitCopyRecord(record, {chunk.buffer});
+    chunk.fence_completion_val = submission;
+    offset += size;
+  }
+
+  return submission;
+}
+
+
+auto GraphicsDevice::StreamTexture(Texture const& dst, UINT const first_subresource, UINT const subresource_count,
+                                   std::span<std::byte const> const src) -> UINT64 {
+  auto const desc{dst.GetInternalResource()->GetDesc1()};
+  std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> footprints(subresource_count);
+  std::vector<UINT> row_counts(subresource_count);
+  std::vector<UINT64> row_sizes(subresource_count);
+  device_->GetCopyableFootprints1(&desc, first_subresource, subresource_count, 0, footprints.data(),
+                                  row_counts.data(), row_sizes.data(), nullptr);
+
+  UINT64 src_size{0};
+
+  for (UINT i{0}; i < subresource_count; i++) {
+    src_size += row_sizes[i] * row_counts[i] * footprints[i].Footprint.Depth;
+  }
+
+  if (src.size() < src_size) {
+    throw std::runtime_error{"Failed to stream texture: the source data is smaller than the subresources."};
+  }
+
+  std::scoped_lock const lock{copy_mutex_};
+
+  details::StreamingChunk* chunk{nullptr};
+  details::CopyRecord* record{nullptr};
+  UINT64 chunk_offset{0};
+  UINT64 submission{0};
+
+  auto const submit_chunk{
+    [&] {
+      if (record) {
+        record->cmd_list->End();
+        submission = SubmitCopyRecord(*record, {chunk->buffer});
+        chunk->fence_completion_val = submission;
+        record = nullptr;
+      }
+    }
+  };
+
+  // Returns the offset of the region within the current chunk, moving to the next chunk if it doesn't fit.
+  auto const allocate{
+    [&](UINT64 const size) -> UINT64 {
+      if (size > streaming_chunk_size_) {
+        throw std::runtime_error{"Failed to stream texture: a texture row doesn't fit into a staging chunk."};
+      }
+
+      auto offset{AlignUp<UINT64>(chunk_offset, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT)};
+
+      if (!record || offset + size > streaming_chunk_size_) {
+        submit_chunk();
+        chunk = &AcquireStreamingChunk();
+        record = &AcquireCopyRecord();
+        record->cmd_list->Begin(nullptr);
+        offset = 0;
+      }
+
+      chunk_offset = offset + size;
+      return offset;
+    }
+  };
+
+  auto const copy_rows{
+    [&](UINT64 const dst_offset, std::byte const* const src_rows, UINT const row_count, UINT64 const row_size,
+        UINT64 const row_pitch) {
+      auto const dst_rows{chunk->buffer->GetMappedData().data() + dst_offset};
+
+      if (row_size == row_pitch) {
+        details::StreamingCopy(dst_rows, src_rows, row_size * row_count);
+        return;
+      }
+
+      for (UINT row{0}; row < row_count; row++) {
+        details::StreamingCopy(dst_rows + row * row_pitch, src_rows + row * row_size, row_size);
+      }
+    }
+  };
+
+  auto src_subresource{src.data()};
+
+  for (UINT i{0}; i < subresource_count; i++) {
+    auto const& footprint{footprints[i]};
+    auto const row_count{row_counts[i]};
+    auto const row_size{row_sizes[i]};
+    auto const row_pitch{static_cast<UINT64>(footprint.Footprint.RowPitch)};
+    auto const depth{footprint.Footprint.Depth};
+
+    if (row_pitch * row_count * depth <= streaming_chunk_size_) {
+      // Small subresources are copied as a whole and share chunks.
+      auto const offset{allocate(row_pitch * row_count * depth)};
+      copy_rows(offset, src_subresource, row_count * depth, row_size, row_pitch);
+
+      auto placed_footprint{footprint};
+      placed_footprint.Offset = offset;
+      record->cmd_list->CopyTextureRegion(dst, first_subresource + i, 0, 0, 0, *chunk->buffer, placed_footprint);
+    } else {
+      // Large subresources are split into row ranges of single slices. Block compressed rows span multiple texels.
+      auto const row_height{footprint.Footprint.Height / row_count};
+      auto const max_rows_per_copy{static_cast<UINT>(streaming_chunk_size_ / row_pitch)};
+
+      for (UINT z{0}; z < depth; z++) {
+        for (UINT first_row{0}; first_row < row_count;) {
+          auto const copy_row_count{std::min(max_rows_per_copy, row_count - first_row)};
+          auto const offset{allocate(row_pitch * copy_row_count)};
+          copy_rows(offset, src_subresource + (static_cast<UINT64>(z) * row_count + first_row) * row_size,
+                    copy_row_count, row_size, row_pitch);
+
+          D3D12_PLACED_SUBRESOURCE_FOOTPRINT const placed_footprint{
+            offset, {
+              footprint.Footprint.Format, footprint.Footprint.Width,
+              std::min(copy_row_count * row_height, footprint.Footprint.Height - first_row * row_height), 1,
+              footprint.Footprint.RowPitch
+            }
+          };
+          record->cmd_list->CopyTextureRegion(dst, first_subresource + i, 0, first_row * row_height, z,
+                                              *chunk->buffer, placed_footprint);
+          first_row += copy_row_count;
+        }
+      }
+    }
+
+    src_subresource += row_size * row_count * depth;
+  }
+
+  submit_chunk();
+  return submission;
+}
+
+
+auto GraphicsDevice::StreamBuffer(Buffer const& dst, UINT64 const dst_offset, std::filesystem::path const& path,
+                                  UINT64 const file_offset, UINT64 const size) -> UINT64 {
+  details::MappedFile const file{path};
+
+  if (file_offset + size > file.GetData().size()) {
+    throw std::runtime_error{"Failed to stream buffer: the requested range is outside of the file."};
+  }
+
+  return StreamBuffer(dst, dst_offset, file.GetData().subspan(file_offset, size));
+}
+
+
+auto GraphicsDevice::StreamTexture(Texture const& dst, UINT const first_subresource, UINT const subresource_count,
+                                   std::filesystem::path const& path, UINT64 const file_offset) -> UINT64 {
+  details::MappedFile const file{path};
+
+  if (file_offset > file.GetData().size()) {
+    throw std::runtime_error{"Failed to stream texture: the offset is outside of the file."};
+  }
+
+  return StreamTexture(dst, first_subresource, subresource_count, file.GetData().subspan(file_offset));
+}
+
+
+auto GraphicsDevice::CreateUploadableBuffer(BufferDesc const& desc) -> SharedDeviceChildHandle<Buffer> {
+  return CreateBuffer(desc, IsDirectUploadSupported() ? CpuAccess::kWrite : CpuAccess::kNone);
+}
+
+
+auto GraphicsDevice::IsDirectUploadSupported() const -> bool {
+  return supported_features_.GPUUploadHeapSupported();
+}
+
+
+auto GraphicsDevice::WriteBuffer(Buffer const& dst, UINT64 const dst_offset,
+                                 std::span<std::byte const> const src) -> UINT64 {
+  if (dst_offset + src.size() > dst.GetDesc().size) {
+    throw std::runtime_error{"Failed to write buffer: the range exceeds the size of the buffer."};
+  }
+
+  auto const mapped_data{dst.GetMappedData()};
+
+  // Upload heap buffers are mapped too, but the GPU would read them over the bus on every access.
+  if (D3D12_HEAP_PROPERTIES heap_props;
+    !mapped_data.empty() && SUCCEEDED(dst.GetInternalResource()->GetHeapProperties(&heap_props, nullptr)) &&
+    heap_props.Type == D3D12_HEAP_TYPE_GPU_UPLOAD) {
+    details::StreamingCopy(mapped_data.data() + dst_offset, src.data(), src.size());
+    return 0;
+  }
+
+  return StreamBuffer(dst, dst_offset, src);
+}
+
+
+auto GraphicsDevice::BenchmarkUploadPaths(UINT64 const size, UINT const iteration_count) -> UploadBenchmarkResult {
+  if (size == 0 || iteration_count == 0) {
+    throw std::runtime_error{"Failed to benchmark upload paths: size and iteration count must be greater than zero."};
+  }
+
+  std::vector<std::byte> data(size);
+  std::ranges::generate(data, [i = std::uint8_t{0}]() mutable {
+    return static_cast<std::byte>(i++);
+  });
+
+  BufferDesc const desc{size, 1, false, false, false};
+
+  // The first write is not measured to exclude the creation of staging memory.
+  auto const measure{
+    [&](Buffer const& buffer) {
+      auto const write{
+        [&] {
+          auto const submission{WriteBuffer(buffer, 0, data)};
+          Flush();
+          WaitSubmission(QueueType::kCopy, submission);
+        }
+      };
+
+      write();
+
+      auto const begin{std::chrono::steady_clock::now()};
+
+      for (UINT i{0}; i < iteration_count; i++) {
+        write();
+      }
+
+      std::chrono::duration<double> const elapsed{std::chrono::steady_clock::now() - begin};
+      return static_cast<double>(size) * iteration_count / elapsed.count();
+    }
+  };
+
+  UploadBenchmarkResult result{};
+  result.staging_bytes_per_second = measure(*CreateBuffer(desc, CpuAccess::kNone));
+
+  if (IsDirectUploadSupported()) {
+    result.direct_bytes_per_second = measure(*CreateBuffer(desc, CpuAccess::kWrite));
+  }
+
+  return result;
+}
+
+
+auto GraphicsDevice::SubmitUploads(UploadQueue& queue) -> UINT64 {
+  auto jobs{queue.TakeJobs()};
+
+  if (!jobs) {
+    return 0;
+  }
+
+  std::scoped_lock const lock{copy_mutex_};
+
+  auto const max_batch_size{queue.GetDesc().max_batch_size};
+  UINT64 submission{0};
+
+  while (jobs) {
+    auto& record{AcquireCopyRecord()};
+    auto& cmd_list{*record.cmd_list};
+    std::vector<SharedDeviceChildHandle<Buffer>> staging_buffers;
+    std::vector<std::shared_ptr<std::atomic<UINT64>>> tickets;
+
+    cmd_list.Begin(nullptr);
+
+    for (UINT job_count{0}; jobs && (max_batch_size == 0 || job_count < max_batch_size); job_count++) {
+      std::unique_ptr<details::UploadJob> const job{std::exchange(jobs, jobs->next)};
+
+      if (job->dst_texture) {
+        cmd_list.CopyTextureRegion(*job->dst_texture, job->dst_subresource, 0, 0, 0, *job->staging, job->footprint);
+      } else {
+        cmd_list.CopyBufferRegion(*job->dst_buffer, job->dst_offset, *job->staging, job->staging_offset, job->size);
+      }
+
+      staging_buffers.emplace_back(std::move(job->staging));
+      tickets.emplace_back(std::move(job->submission));
+    }
+
+    cmd_list.End();
+
+    submission = SubmitCopyRecord(record, std::move(staging_buffers));
+
+    for (auto const& ticket : tickets) {
+      ticket->store(submission, std::memory_order_release);
+    }
+  }
+
+  return submission;
+}
+
+
+auto GraphicsDevice::GetMemoryBudget() const -> MemoryBudget {
+  D3D12MA::Budget local;
+  D3D12MA::Budget non_local;
+  allocator_->GetBudget(&local, &non_local);
+  return MemoryBudget{local.UsageBytes, local.BudgetBytes, non_local.UsageBytes, non_local.BudgetBytes};
+}
+
+
+auto GraphicsDevice::GetMemoryStatistics() const -> MemoryStatistics {
+  D3D12MA::TotalStatistics stats;
+  allocator_->CalculateStatistics(&stats);
+
+  auto const as_usage{
+    [](D3D12MA::DetailedStatistics const& detailed) {
+      return MemoryUsage{
+        detailed.Stats.BlockBytes, detailed.Stats.AllocationBytes, detailed.Stats.BlockCount,
+        detailed.Stats.AllocationCount
+      };
+    }
+  };
+
+  MemoryStatistics ret{
+    .total = as_usage(stats.Total), .default_heap = as_usage(stats.HeapType[0]),
+    .upload_heap = as_usage(stats.HeapType[1]), .readback_heap = as_usage(stats.HeapType[2]),
+    .custom_heap = as_usage(stats.HeapType[3]), .gpu_upload_heap = as_usage(stats.HeapType[4]), .categories = {}
+  };
+
+  auto other_bytes{ret.total.allocation_bytes};
+  UINT64 other_count{ret.total.allocation_count};
+
+  for (std::size_t i{0}; i < kMemoryCategoryCount; i++) {
+    if (i == static_cast<std::size_t>(MemoryCategory::kOther)) {
+      continue;
+    }
+
+    ret.categories[i] = {memory_categories_[i].bytes, memory_categories_[i].allocation_count};
+    // The counters may be updated concurrently with the statistics calculation.
+    other_bytes -= std::min(other_bytes, ret.categories[i].bytes);
+    other_count -= std::min(other_count, ret.categories[i].allocation_count);
+  }
+
+  ret.categories[static_cast<std::size_t>(MemoryCategory::kOther)] = {other_bytes, other_count};
+  return ret;
+}
+
+
+auto GraphicsDevice::BuildMemoryStatsJson(bool const detailed_map) const -> std::wstring {
+  WCHAR* stats_str;
+  allocator_->BuildStatsString(&stats_str, detailed_map);
+  std::wstring ret{stats_str};
+  allocator_->FreeStatsString(stats_str);
+  return ret;
+}
+
+
+auto GraphicsDevice::RegisterBudgetCallback(float const usage_ratio, BudgetCallback callback) -> UINT {
+  std::scoped_lock const lock{budget_mutex_};
+  auto const id{next_budget_callback_id_++};
+  budget_callbacks_.emplace_back(details::BudgetCallbackRecord{id, usage_ratio, std::move(callback)});
+  return id;
+}
+
+
+auto GraphicsDevice::UnregisterBudgetCallback(UINT const id) -> void {
+  std::scoped_lock const lock{budget_mutex_};
+  std::erase_if(budget_callbacks_, [id](details::BudgetCallbackRecord const& record) {
+    return record.id == id;
+  });
+}
+
+
+auto GraphicsDevice::SetBudgetEnforcement(bool const enforce) -> void {
+  enforce_budget_ = enforce;
+}
+
+
+auto GraphicsDevice::SetEvictionThreshold(float const usage_ratio) -> void {
+  eviction_threshold_ = usage_ratio;
+}
+
+
+auto GraphicsDevice::SetBufferSubAllocationThreshold(UINT64 const size) -> void {
+  if (size > buffer_page_size_) {
+    throw std::runtime_error{"Failed to set buffer sub-allocation threshold: the threshold exceeds the page size."};
+  }
+
+  buffer_sub_allocation_threshold_ = size;
+}
+
+
+auto GraphicsDevice::Defragment(UINT64 const budget_bytes, UINT const budget_moves,
+                                MemoryPool const* const pool) -> DefragmentationStats {
+  D3D12MA::DEFRAGMENTATION_DESC const defrag_desc{
+    D3D12MA::DEFRAGMENTATION_FLAG_ALGORITHM_BALANCED, budget_bytes, budget_moves
+  };
+
+  ComPtr<D3D12MA::DefragmentationContext> ctx;
+
+  if (pool) {
+    ThrowIfFailed(pool->pool_->BeginDefragmentation(&defrag_desc, &ctx),
+                  "Failed to begin memory pool defragmentation.");
+  } else {
+    allocator_->BeginDefragmentation(&defrag_desc, &ctx);
+  }
+
+  // Every pass waits for its copies, so the command list is free again by the next call.
+  if (!defragmentation_cmd_list_) {
+    defragmentation_cmd_list_ = CreateCommandList(QueueType::kGraphics);
+  }
+
+  auto const& cmd_list{defragmentation_cmd_list_};
+  std::vector<details::DefragmentationMove> moves;
+  std::vector<D3D12_TEXTURE_BARRIER> src_barriers;
+  std::vector<D3D12_TEXTURE_BARRIER> dst_barriers;
+
+  for (;;) {
+    D3D12MA::DEFRAGMENTATION_PASS_MOVE_INFO pass;
+    auto hr{ctx->BeginPass(&pass)};
+
+    if (hr == S_OK) {
+      break;
+    }
+
+    ThrowIfFailed(hr, "Failed to begin defragmentation pass.");
+
+    moves.clear();
+    src_barriers.clear();
+    dst_barriers.clear();
+
+    UINT64 fence_val;
+
+    {
+      std::scoped_lock const lock{submit_mutex_};
+
+      details::QueueTransfer transfer;
+
+      for (auto& move : std::span{pass.pMoves, pass.MoveCount}) {
+        // Aliased memory has no resource of its own and no owner in its private data.
+        if (!move.pSrcAllocation->GetResource()) {
+          move.Operation = D3D12MA::DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+          continue;
+        }
+
+        auto const resource{static_cast<Resource*>(move.pSrcAllocation->GetPrivateData())};
+        auto const heap{move.pSrcAllocation->GetHeap()};
+
+        // Mapped memory would have to be remapped, and bundles can't be updated to the new resource.
+        if (!resource || !heap || move.pSrcAllocation->GetResource() != resource->resource_.Get() ||
+            heap->GetDesc().Properties.Type != D3D12_HEAP_TYPE_DEFAULT || resource->bundle_usage_count_ != 0) {
+          move.Operation = D3D12MA::DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+          continue;
+        }
+
+        PrepareQueueTransfer(resource->resource_.Get(), QueueType::kGraphics, transfer);
+        moves.emplace_back(details::DefragmentationMove{resource, move.pDstTmpAllocation});
+      }
+
+      ExecuteQueueTransfer(transfer, QueueType::kGraphics);
+
+      constexpr D3D12_BARRIER_SUBRESOURCE_RANGE all_subresources{
+        .IndexOrFirstMipLevel = 0xffffffff, .NumMipLevels = 0, .FirstArraySlice = 0, .NumArraySlices = 0,
+        .FirstPlane = 0, .NumPlanes = 0
+      };
+
+      for (auto& move : moves) {
+        auto const old_resource{move.resource->resource_.Get()};
+        auto const res_desc{old_resource->GetDesc1()};
+        auto const is_buffer{res_desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER};
+
+        if (auto const state{global_resource_states_.Get(old_resource)}) {
+          move.layout = state->layout;
+        }
+
+        // Textures without defined contents are recreated without copying.
+        move.copy = is_buffer || move.layout != D3D12_BARRIER_LAYOUT_UNDEFINED;
+
+        // Render targets and depth stencils keep their optimized clear values.
+        D3D12_CLEAR_VALUE const* clear_value{nullptr};
+
+        if (!is_buffer) {
+          if (auto const& tex_clear_value{static_cast<Texture*>(move.resource)->clear_value_}) {
+            clear_value = &*tex_clear_value;
+          }
+        }
+
+        ThrowIfFailed(device_->CreatePlacedResource2(move.dst_allocation->GetHeap(), move.dst_allocation->GetOffset(),
+                                                     &res_desc,
+                                                     is_buffer || !move.copy
+                                                       ? D3D12_BARRIER_LAYOUT_UNDEFINED
+                                                       : D3D12_BARRIER_LAYOUT_COPY_DEST,
+                                                     clear_value, 0, nullptr,
+                                                     IID_PPV_ARGS(&move.new_resource)),
+                      "Failed to create resource at defragmentation destination.");
+        move.dst_allocation->SetResource(move.new_resource.Get());
+
+        if (!is_buffer && move.copy) {
+          src_barriers.emplace_back(D3D12_BARRIER_SYNC_NONE, D3D12_BARRIER_SYNC_COPY, D3D12_BARRIER_ACCESS_NO_ACCESS,
+                                    D3D12_BARRIER_ACCESS_COPY_SOURCE, move.layout, D3D12_BARRIER_LAYOUT_COPY_SOURCE,
+                                    old_resource, all_subresources, D3D12_TEXTURE_BARRIER_FLAG_NONE);
+          dst_barriers.emplace_back(D3D12_BARRIER_SYNC_COPY, D3D12_BARRIER_SYNC_NONE, D3D12_BARRIER_ACCESS_COPY_DEST,
+                                    D3D12_BARRIER_ACCESS_NO_ACCESS, D3D12_BARRIER_LAYOUT_COPY_DEST, move.layout,
+                                    move.new_resource.Get(), all_subresources, D3D12_TEXTURE_BARRIER_FLAG_NONE);
+        }
+      }
+
+      cmd_list->Begin(nullptr);
+
+      if (!src_barriers.empty()) {
+        D3D12_BARRIER_GROUP const barrier_group{
+          .Type = D3D12_BARRIER_TYPE_TEXTURE, .NumBarriers = ClampCast<UINT32>(src_barriers.size()),
+          .pTextureBarriers = src_barriers.data()
+        };
+        cmd_list->cmd_list_->Barrier(1, &barrier_group);
+      }
+
+      for (auto const& move : moves) {
+        if (move.copy) {
+          cmd_list->cmd_list_->CopyResource(move.new_resource.Get(), move.resource->resource_.Get());
+        }
+      }
+
+      if (!dst_barriers.empty()) {
+        D3D12_BARRIER_GROUP const barrier_group{
+          .Type = D3D12_BARRIER_TYPE_TEXTURE, .NumBarriers = ClampCast<UINT32>(dst_barriers.size()),
+          .pTextureBarriers = dst_barriers.data()
+        };
+        cmd_list->cmd_list_->Barrier(1, &barrier_group);
+      }
+
+      cmd_list->End();
+
+      auto& queue{GetQueue(QueueType::kGraphics)};
+      fence_val = queue.fence->GetNextValue();
+
+      // Both the source and the destination memory may have been evicted.
+      std::vector<ID3D12Pageable*> evicted_pageables;
+
+      for (auto const& move : moves) {
+        RegisterResidency(move.dst_allocation, move.new_resource.Get());
+        residency_manager_->MarkUsed(move.resource->resource_.Get(), QueueType::kGraphics, fence_val,
+                                     evicted_pageables);
+        residency_manager_->MarkUsed(move.new_resource.Get(), QueueType::kGraphics, fence_val, evicted_pageables);
+      }
+
+      MakeResident(evicted_pageables, QueueType::kGraphics);
+      queue.pending_cmd_lists.emplace_back(cmd_list->cmd_list_.Get());
+      FlushQueue(QueueType::kGraphics);
+
+      for (auto const& move : moves) {
+        global_resource_states_.Erase(move.resource->resource_.Get());
+        global_resource_states_.Record(move.new_resource.Get(), {
+                                         .layout = move.layout, .queue = QueueType::kGraphics,
+                                         .queue_fence_val = fence_val
+                                       });
+      }
+    }
+
+    // The old resources are released at the end of the pass, and their descriptors are rewritten.
+    WaitSubmission(QueueType::kGraphics, fence_val);
+
+    for (auto const& move : moves) {
+      if (move.new_resource->GetDesc1().Dimension == D3D12_RESOURCE_DIMENSION_BUFFER) {
+        auto const buffer{static_cast<Buffer*>(move.resource)};
+        WriteBufferViews(*move.new_resource.Get(), buffer->offset_, buffer->desc_,
+                         buffer->cbv_.value_or(kInvalidResourceIndex), buffer->srv_.value_or(kInvalidResourceIndex),
+                         buffer->uav_.value_or(kInvalidResourceIndex));
+      } else {
+        auto const texture{static_cast<Texture*>(move.resource)};
+        WriteTextureViews(*move.new_resource.Get(), texture->desc_, texture->dsvs_, texture->rtvs_, texture->srv_,
+                          texture->uav_);
+      }
+
+      UnregisterResidency(move.resource->resource_.Get());
+      move.resource->resource_ = move.new_resource;
+    }
+
+    hr = ctx->EndPass(&pass);
+
+    if (hr == S_OK) {
+      break;
+    }
+
+    ThrowIfFailed(hr, "Failed to end defragmentation pass.");
+  }
+
+  D3D12MA::DEFRAGMENTATION_STATS stats;
+  ctx->GetStats(&stats);
+
+  return DefragmentationStats{stats.BytesMoved, stats.BytesFreed, stats.AllocationsMoved, stats.HeapsFreed};
+}
+
+
+auto GraphicsDevice::GetCopyableFootprints(TextureDesc const& desc, UINT const first_subresource,
+                                           UINT const subresource_count, UINT64 const base_offset,
+                                           D3D12_PLACED_SUBRESOURCE_FOOTPRINT* const layouts, UINT* const row_counts,
+                                           UINT64* const row_sizes, UINT64* const total_size) const -> void {
+  auto const tex_desc{AsD3d12Desc(desc)};
+  return device_->GetCopyableFootprints1(&tex_desc, first_subresource, subresource_count, base_offset, layouts,
+                                         row_counts, row_sizes, total_size);
+}
+
+
+auto GraphicsDevice::SwapChainCreateTextures(SwapChain& swap_chain) -> void {
+  DXGI_SWAP_CHAIN_DESC1 desc;
+  ThrowIfFailed(swap_chain.swap_chain_->GetDesc1(&desc), "Failed to retrieve swap chain desc.");
+
+  TextureDesc const tex_desc{
+    TextureDimension::k2D, desc.Width, desc.Height, 1, 1, desc.Format, 1, false,
+    (desc.BufferUsage & DXGI_USAGE_RENDER_TARGET_OUTPUT) != 0, (desc.BufferUsage & DXGI_USAGE_SHADER_INPUT) != 0, false
+  };
+
+  for (UINT i{0}; i < desc.BufferCount; i++) {
+    ComPtr<ID3D12Resource2> buf;
+    ThrowIfFailed(swap_chain.swap_chain_->GetBuffer(i, IID_PPV_ARGS(&buf)), "Failed to retrieve swap chain buffer.");
+
+    std::vector<UINT> dsvs;
+    std::vector<UINT> rtvs;
+    std::optional<UINT> srv;
+    std::optional<UINT> uav;
+
+    CreateTextureViews(*buf.Get(), tex_desc, dsvs, rtvs, srv, uav);
+
+    global_resource_states_.Record(buf.Get(), {.layout = D3D12_BARRIER_LAYOUT_COMMON});
+
+    swap_chain.textures_.emplace_back(new Texture{
+                                        nullptr, std::move(buf), {}, std::move(rtvs), srv,
+                                        kInvalidResourceIndex, tex_desc, nullptr
+                                      }, DeviceChildDeleter<Texture>{*this});
+  }
+}
+
+
+auto GraphicsDevice::CreateBufferViews(ID3D12Resource2& buffer, UINT64 const offset, BufferDesc const& desc, UINT& cbv,
+                                       UINT& srv, UINT& uav) const -> void {
+  cbv = desc.constant_buffer ? res_desc_heap_->Allocate() : kInvalidResourceIndex;
+  srv = desc.shader_resource ? res_desc_heap_->Allocate() : kInvalidResourceIndex;
+  uav = desc.unordered_access ? res_desc_heap_->Allocate() : kInvalidResourceIndex;
+  WriteBufferViews(buffer, offset, desc, cbv, srv, uav);
+}
+
+
+auto GraphicsDevice::WriteBufferViews(ID3D12Resource2& buffer, UINT64 const offset, BufferDesc const& desc,
+                                      UINT const cbv, UINT const srv, UINT const uav) const -> void {
+  // Raw views address the buffer in 4 byte units, structured views in elements.
+  auto const element_size{desc.stride == 1 ? 4 : desc.stride};
+
+  if (cbv != kInvalidResourceIndex) {
+    D3D12_CONSTANT_BUFFER_VIEW_DESC const cbv_desc{
+      buffer.GetGPUVirtualAddress() + offset, static_cast<UINT>(desc.size)
+    };
+    device_->CreateConstantBufferView(&cbv_desc, res_desc_heap_->GetDescriptorCpuHandle(cbv));
+  }
+
+  if (srv != kInvalidResourceIndex) {
+    D3D12_SHADER_RESOURCE_VIEW_DESC const srv_desc{
+      .Format = desc.stride == 1 ? DXGI_FORMAT_R32_TYPELESS : DXGI_FORMAT_UNKNOWN,
+      .ViewDimension = D3D12_SRV_DIMENSION_BUFFER, .Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING,
+      .Buffer = {
+        offset / element_size, static_cast<UINT>(desc.size / element_size), desc.stride == 1 ? 0 : desc.stride,
+        desc.stride == 1 ? D3D12_BUFFER_SRV_FLAG_RAW : D3D12_BUFFER_SRV_FLAG_NONE
+      }
+    };
+    device_->CreateShaderResourceView(&buffer, &srv_desc, res_desc_heap_->GetDescriptorCpuHandle(srv));
+  }
+
+  if (uav != kInvalidResourceIndex) {
     D3D12_UNORDERED_ACCESS_VIEW_DESC const uav_desc{
       .Format = desc.stride == 1 ? DXGI_FORMAT_R32_TYPELESS : DXGI_FORMAT_UNKNOWN,
       .ViewDimension = D3D12_UAV_DIMENSION_BUFFER, .Buffer = {
-        .FirstElement = 0, .NumElements = static_cast<UINT>(desc.size / (desc.stride == 1 ? 4 : desc.stride)),
+        .FirstElement = offset / element_size, .NumElements = static_cast<UINT>(desc.size / element_size),
         .StructureByteStride = desc.stride == 1 ? 0 : desc.stride, .CounterOffsetInBytes = 0,
         .Flags = desc.stride == 1 ? D3D12_BUFFER_UAV_FLAG_RAW : D3D12_BUFFER_UAV_FLAG_NONE
       }
     };
-    device_->CreateUnorderedAccessView(&buffer, nullptr, &uav_desc, res_desc_heap_->GetDescriptorCpuHandle(uav));
-  } else {
-    uav = kInvalidResourceIndex;
+    device_->CreateUnorderedAccessView(&buffer, nullptr, &uav_desc, res_desc_heap_->GetDescriptorCpuHandle(uav));
+  }
+}
+
+
+auto GraphicsDevice::CreateTextureViews(ID3D12Resource2& texture, TextureDesc const& desc, std::vector<UINT>& dsvs,
+                                        std::vector<UINT>& rtvs, std::optional<UINT>& srv,
+                                        std::optional<UINT>& uav) const -> void {
+  auto const actual_mip_levels{GetActualMipLevels(desc)};
+
+  if (desc.depth_stencil) {
+    dsvs.resize(actual_mip_levels);
+    std::ranges::generate(dsvs, [this] {
+      return dsv_heap_->Allocate();
+    });
+  }
+
+  if (desc.render_target) {
+    rtvs.resize(actual_mip_levels);
+    std::ranges::generate(rtvs, [this] {
+      return rtv_heap_->Allocate();
+    });
+  }
+
+  if (desc.shader_resource) {
+    srv = res_desc_heap_->Allocate();
+  }
+
+  if (desc.unordered_access) {
+    uav = res_desc_heap_->Allocate();
+  }
+
+  WriteTextureViews(texture, desc, dsvs, rtvs, srv, uav);
+}
+
+
+auto GraphicsDevice::WriteTextureViews(ID3D12Resource2& texture, TextureDesc const& desc,
+                                       std::span<UINT const> const dsvs, std::span<UINT const> const rtvs,
+                                       std::optional<UINT> const srv, std::optional<UINT> const uav) const -> void {
+  DXGI_FORMAT dsv_format;
+  DXGI_FORMAT rtv_srv_uav_format;
+
+  // If a depth format is specified, we have to determine the rtv/srv/uav format.
+  if (desc.format == DXGI_FORMAT_D32_FLOAT_S8X24_UINT) {
+    dsv_format = desc.format;
+    rtv_srv_uav_format = DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS;
+  } else if (desc.format == DXGI_FORMAT_D32_FLOAT) {
+    dsv_format = desc.format;
+    rtv_srv_uav_format = DXGI_FORMAT_R32_FLOAT;
+  } else if (desc.format == DXGI_FORMAT_D24_UNORM_S8_UINT) {
+    dsv_format = desc.format;
+    rtv_srv_uav_format = DXGI_FORMAT_R24_UNORM_X8_TYPELESS;
+  } else if (desc.format == DXGI_FORMAT_D16_UNORM) {
+    dsv_format = desc.format;
+    rtv_srv_uav_format = DXGI_FORMAT_R16_UNORM;
+  } else {
+    dsv_format = desc.format;
+    rtv_srv_uav_format = desc.format;
+  }
+
+  auto const actual_mip_levels{GetActualMipLevels(desc)};
+
+  if (desc.depth_stencil) {
+    for (UINT16 i{0}; i < actual_mip_levels; ++i) {
+      D3D12_DEPTH_STENCIL_VIEW_DESC dsv_desc{.Format = dsv_format, .Flags = D3D12_DSV_FLAG_NONE};
+
+      if (desc.dimension == TextureDimension::k1D) {
+        if (desc.depth_or_array_size == 1) {
+          dsv_desc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE1D;
+          dsv_desc.Texture1D.MipSlice = i;
+        } else {
+          dsv_desc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE1DARRAY;
+          dsv_desc.Texture1DArray.MipSlice = i;
+          dsv_desc.Texture1DArray.FirstArraySlice = 0;
+          dsv_desc.Texture1DArray.ArraySize = desc.depth_or_array_size;
+        }
+      } else if (desc.dimension == TextureDimension::k2D && desc.depth_or_array_size == 1) {
+        if (desc.sample_count == 1) {
+          dsv_desc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D;
+          dsv_desc.Texture2D.MipSlice = i;
+        } else {
+          dsv_desc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2DMS;
+        }
+      } else if ((desc.dimension == TextureDimension::k2D && desc.depth_or_array_size > 1) || desc.dimension ==
+        TextureDimension::kCube) {
+        if (desc.sample_count == 1) {
+          dsv_desc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2DARRAY;
+          dsv_desc.Texture2DArray.MipSlice = i;
+          dsv_desc.Texture2DArray.FirstArraySlice = 0;
+          dsv_desc.Texture2DArray.ArraySize = desc.depth_or_array_size;
+        } else {
+          dsv_desc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2DMSARRAY;
+          dsv_desc.Texture2DMSArray.FirstArraySlice = 0;
+          dsv_desc.Texture2DMSArray.ArraySize = desc.depth_or_array_size;
+        }
+      } else {
+        throw std::runtime_error{"Cannot create depth stencil view for texture."};
+      }
+
+      device_->CreateDepthStencilView(&texture, &dsv_desc, dsv_heap_->GetDescriptorCpuHandle(dsvs[i]));
+    }
+  }
+
+  if (desc.render_target) {
+    for (UINT16 i{0}; i < actual_mip_levels; ++i) {
+      D3D12_RENDER_TARGET_VIEW_DESC rtv_desc{.Format = rtv_srv_uav_format};
+
+      if (desc.dimension == TextureDimension::k1D) {
+        if (desc.depth_or_array_size == 1) {
+          rtv_desc.ViewDimension = D3D12_RTV_DIMENSION_TEXTURE1D;
+          rtv_desc.Texture1D.MipSlice = i;
+        } else {
+          rtv_desc.ViewDimension = D3D12_RTV_DIMENSION_TEXTURE1DARRAY;
+          rtv_desc.Texture1DArray.MipSlice = i;
+          rtv_desc.Texture1DArray.FirstArraySlice = 0;
+          rtv_desc.Texture1DArray.ArraySize = desc.depth_or_array_size;
+        }
+      } else if (desc.dimension == TextureDimension::k2D && desc.depth_or_array_size == 1) {
+        if (desc.sample_count == 1) {
+          rtv_desc.ViewDimension = D3D12_RTV_DIMENSION_TEXTURE2D;
+          rtv_desc.Texture2D.MipSlice = i;
+          rtv_desc.Texture2D.PlaneSlice = 0;
+        } else {
+          rtv_desc.ViewDimension = D3D12_RTV_DIMENSION_TEXTURE2DMS;
+        }
+      } else if ((desc.dimension == TextureDimension::k2D && desc.depth_or_array_size > 1) || desc.dimension ==
+        TextureDimension::kCube) {
+        if (desc.sample_count == 1) {
+          rtv_desc.ViewDimension = D3D12_RTV_DIMENSION_TEXTURE2DARRAY;
+          rtv_desc.Texture2DArray.MipSlice = i;
+          rtv_desc.Texture2DArray.FirstArraySlice = 0;
+          rtv_desc.Texture2DArray.ArraySize = desc.depth_or_array_size;
+          rtv_desc.Texture2DArray.PlaneSlice = 0;
+        } else {
+          rtv_desc.ViewDimension = D3D12_RTV_DIMENSION_TEXTURE2DMSARRAY;
+          rtv_desc.Texture2DMSArray.FirstArraySlice = 0;
+          rtv_desc.Texture2DMSArray.ArraySize = desc.depth_or_array_size;
+        }
+      } else if (desc.dimension == TextureDimension::k3D) {
+        rtv_desc.ViewDimension = D3D12_RTV_DIMENSION_TEXTURE3D;
+        rtv_desc.Texture3D.MipSlice = i;
+        rtv_desc.Texture3D.FirstWSlice = 0;
+        rtv_desc.Texture3D.WSize = static_cast<UINT>(-1);
+      } else {
+        throw std::runtime_error{"Cannot create render target view for texture."};
+      }
+
+      device_->CreateRenderTargetView(&texture, &rtv_desc, rtv_heap_->GetDescriptorCpuHandle(rtvs[i]));
+    }
+  }
+
+  if (srv) {
+    D3D12_SHADER_RESOURCE_VIEW_DESC srv_desc{
+      .Format = rtv_srv_uav_format, .Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING
+    };
+    if (desc.dimension == TextureDimension::k1D) {
+      if (desc.depth_or_array_size == 1) {
+        srv_desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE1D;
+        srv_desc.Texture1D.MostDetailedMip = 0;
+        srv_desc.Texture1D.MipLevels = static_cast<UINT>(-1);
+        srv_desc.Texture1D.ResourceMinLODClamp = 0.0f;
+      } else {
+        srv_desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE1DARRAY;
+        srv_desc.Texture1DArray.MostDetailedMip = 0;
+        srv_desc.Texture1DArray.MipLevels = static_cast<UINT>(-1);
+        srv_desc.Texture1DArray.FirstArraySlice = 0;
+        srv_desc.Texture1DArray.ArraySize = desc.depth_or_array_size;
+        srv_desc.Texture1DArray.ResourceMinLODClamp = 0.0f;
+      }
+    } else if (desc.dimension == TextureDimension::k2D) {
+      if (desc.depth_or_array_size == 1) {
+        if (desc.sample_count == 1) {
+          srv_desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+          srv_desc.Texture2D.MostDetailedMip = 0;
+          srv_desc.Texture2D.MipLevels = static_cast<UINT>(-1);
+          srv_desc.Texture2D.PlaneSlice = 0;
+          srv_desc.Texture2D.ResourceMinLODClamp = 0.0f;
+        } else {
+          srv_desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2DMS;
+        }
+      } else {
+        if (desc.sample_count == 1) {
+          srv_desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2DARRAY;
+          srv_desc.Texture2DArray.MostDetailedMip = 0;
+          srv_desc.Texture2DArray.MipLevels = static_cast<UINT>(-1);
+          srv_desc.Texture2DArray.FirstArraySlice = 0;
+          srv_desc.Texture2DArray.ArraySize = desc.depth_or_array_size;
+          srv_desc.Texture2DArray.PlaneSlice = 0;
+          srv_desc.Texture2DArray.ResourceMinLODClamp = 0.0f;
+        } else {
+          srv_desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2DMSARRAY;
+          srv_desc.Texture2DMSArray.FirstArraySlice = 0;
+          srv_desc.Texture2DMSArray.ArraySize = desc.depth_or_array_size;
+        }
+      }
+    } else if (desc.dimension == TextureDimension::k3D) {
+      srv_desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE3D;
+      srv_desc.Texture3D.MostDetailedMip = 0;
+      srv_desc.Texture3D.MipLevels = static_cast<UINT>(-1);
+      srv_desc.Texture3D.ResourceMinLODClamp = 0.0f;
+    } else if (desc.dimension == TextureDimension::kCube) {
+      if (desc.depth_or_array_size == 6) {
+        srv_desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURECUBE;
+        srv_desc.TextureCube.MostDetailedMip = 0;
+        srv_desc.TextureCube.MipLevels = static_cast<UINT>(-1);
+        srv_desc.TextureCube.ResourceMinLODClamp = 0.0f;
+      } else {
+        srv_desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURECUBEARRAY;
+        srv_desc.TextureCubeArray.MostDetailedMip = 0;
+        srv_desc.TextureCubeArray.MipLevels = static_cast<UINT>(-1);
+        srv_desc.TextureCubeArray.First2DArrayFace = 0;
+        srv_desc.TextureCubeArray.NumCubes = desc.depth_or_array_size / 6;
+        srv_desc.TextureCubeArray.ResourceMinLODClamp = 0.0f;
+      }
+    } else {
+      throw std::runtime_error{"Cannot create shader resource view for texture."};
+    }
+    device_->CreateShaderResourceView(&texture, &srv_desc, res_desc_heap_->GetDescriptorCpuHandle(*srv));
+  }
+
+  if (uav) {
+    D3D12_UNORDERED_ACCESS_VIEW_DESC uav_desc{.Format = rtv_srv_uav_format};
+    if (desc.dimension == TextureDimension::k1D) {
+      if (desc.depth_or_array_size == 1) {
+        uav_desc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE1D;
+        uav_desc.Texture1D.MipSlice = 0;
+      } else {
+        uav_desc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE1DARRAY;
+        uav_desc.Texture1DArray.MipSlice = 0;
+        uav_desc.Texture1DArray.FirstArraySlice = 0;
+        uav_desc.Texture1DArray.ArraySize = desc.depth_or_array_size;
+      }
+    } else if (desc.dimension == TextureDimension::k2D && desc.depth_or_array_size == 1) {
+      if (desc.sample_count == 1) {
+        uav_desc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
+        uav_desc.Texture2D.MipSlice = 0;
+        uav_desc.Texture2D.PlaneSlice = 0;
+      } else {
+        uav_desc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2DMS;
+      }
+    } else if ((desc.dimension == TextureDimension::k2D && desc.depth_or_array_size > 1) || desc.dimension ==
+      TextureDimension::k3D) {
+      if (desc.sample_count == 1) {
+        uav_desc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2DARRAY;
+        uav_desc.Texture2DArray.MipSlice = 0;
+        uav_desc.Texture2DArray.FirstArraySlice = 0;
+        uav_desc.Texture2DArray.ArraySize = desc.depth_or_array_size;
+        uav_desc.Texture2DArray.PlaneSlice = 0;
+      } else {
+        uav_desc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2DMSARRAY;
+        uav_desc.Texture2DMSArray.FirstArraySlice = 0;
+        uav_desc.Texture2DMSArray.ArraySize = desc.depth_or_array_size;
+      }
+    } else if (desc.dimension == TextureDimension::k3D) {
+      uav_desc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE3D;
+      uav_desc.Texture3D.MipSlice = 0;
+      uav_desc.Texture3D.FirstWSlice = 0;
+      uav_desc.Texture3D.WSize = static_cast<UINT>(-1);
+    } else {
+      throw std::runtime_error{"Cannot create unordered access view for texture."};
+    }
+    device_->CreateUnorderedAccessView(&texture, nullptr, &uav_desc, res_desc_heap_->GetDescriptorCpuHandle(*uav));
+  }
+}
+
+
+auto GraphicsDevice::CreateSubAllocatedBuffer(BufferDesc const& desc, CpuAccess const cpu_access,
+                                              UINT64 const alignment) -> SharedDeviceChildHandle<Buffer> {
+  auto const flags{AsD3d12Desc(desc).Flags};
+
+  details::BufferPage* page{nullptr};
+  UINT64 offset{0};
+
+  {
+    std::scoped_lock const lock{buffer_page_mutex_};
+
+    for (auto const& candidate : buffer_pages_) {
+      if (candidate->cpu_access != cpu_access || candidate->flags != flags) {
+        continue;
+      }
+
+      if (auto const candidate_offset{candidate->allocator.Allocate(desc.size, alignment)}) {
+        page = candidate.get();
+        offset = *candidate_offset;
+        break;
+      }
+    }
+
+    if (!page) {
+      ComPtr<D3D12MA::Allocation> allocation;
+      ComPtr<ID3D12Resource2> resource;
+
+      auto const alloc_desc{MakeAllocationDesc(cpu_access, nullptr)};
+      auto const res_desc{CD3DX12_RESOURCE_DESC1::Buffer(buffer_page_size_, flags)};
+
+      ThrowIfFailed(allocator_->CreateResource3(&alloc_desc, &res_desc, D3D12_BARRIER_LAYOUT_UNDEFINED, nullptr, 0,
+                                                nullptr, &allocation, IID_PPV_ARGS(&resource)),
+                    "Failed to create buffer page.");
+
+      // Buffers of the page share the state of its resource.
+      global_resource_states_.Record(resource.Get(), {.layout = D3D12_BARRIER_LAYOUT_UNDEFINED});
+      TrackMemoryCategory(allocation.Get(), resource.Get(), MemoryCategory::kBuffer, true);
+      RegisterResidency(allocation.Get(), resource.Get());
+      allocation->SetName(L"Buffer Page");
+
+      std::byte* mapped_data{nullptr};
+
+      if (cpu_access != CpuAccess::kNone) {
+        D3D12_RANGE constexpr read_range{0, 0};
+        void* mapped;
+        ThrowIfFailed(resource->Map(0, &read_range, &mapped), "Failed to map buffer page.");
+        mapped_data = static_cast<std::byte*>(mapped);
+      }
+
+      page = buffer_pages_.emplace_back(std::make_unique<details::BufferPage>(details::BufferPage{
+        std::move(allocation), std::move(resource), cpu_access, flags, details::TlsfAllocator{buffer_page_size_},
+        mapped_data
+      })).get();
+      // The threshold never exceeds the page size, so the buffer always fits at the start of a new page.
+      offset = page->allocator.Allocate(desc.size, alignment).value();
+    }
+  }
+
+  UINT cbv;
+  UINT srv;
+  UINT uav;
+  CreateBufferViews(*page->resource.Get(), offset, desc, cbv, srv, uav);
+
+  return SharedDeviceChildHandle<Buffer>{
+    new Buffer{nullptr, page->resource, cbv, srv, uav, desc, cpu_access, offset, page},
+    DeviceChildDeleter<Buffer>{*this}
+  };
+}
+
+
+auto GraphicsDevice::CreateAliasingBuffer(ComPtr<D3D12MA::Allocation> const& allocation, UINT64 const offset,
+                                          BufferDesc const& desc,
+                                          CpuAccess const cpu_access) -> SharedDeviceChildHandle<Buffer> {
+  auto const res_desc{AsD3d12Desc(desc)};
+  ComPtr<ID3D12Resource2> resource;
+
+  ThrowIfFailed(allocator_->CreateAliasingResource2(allocation.Get(), offset, &res_desc, D3D12_BARRIER_LAYOUT_UNDEFINED,
+                                                    nullptr, 0, nullptr, IID_PPV_ARGS(&resource)),
+                "Failed to create aliasing buffer.");
+
+  UINT cbv;
+  UINT srv;
+  UINT uav;
+  CreateBufferViews(*resource.Get(), 0, desc, cbv, srv, uav);
+
+  global_resource_states_.Record(resource.Get(), {.layout = D3D12_BARRIER_LAYOUT_UNDEFINED});
+  RegisterResidency(allocation.Get(), resource.Get());
+
+  return SharedDeviceChildHandle<Buffer>{
+    new Buffer{allocation, std::move(resource), cbv, srv, uav, desc, cpu_access, 0, nullptr},
+    DeviceChildDeleter<Buffer>{*this}
+  };
+}
+
+
+auto GraphicsDevice::CreateAliasingTexture(ComPtr<D3D12MA::Allocation> const& allocation, UINT64 const offset,
+                                           AliasedTextureCreateInfo const& info) -> SharedDeviceChildHandle<Texture> {
+  auto res_desc{AsD3d12Desc(info.desc)};
+  res_desc.Format = MakeDepthTypeless(info.desc.format);
+  ComPtr<ID3D12Resource2> resource;
+
+  ThrowIfFailed(allocator_->CreateAliasingResource2(allocation.Get(), offset, &res_desc, info.initial_layout,
+                                                    info.clear_value, 0, nullptr, IID_PPV_ARGS(&resource)),
+                "Failed to create aliasing texture.");
+
+  std::vector<UINT> dsvs;
+  std::vector<UINT> rtvs;
+  std::optional<UINT> srv;
+  std::optional<UINT> uav;
+  CreateTextureViews(*resource.Get(), info.desc, dsvs, rtvs, srv, uav);
+
+  global_resource_states_.Record(resource.Get(), {.layout = info.initial_layout});
+  RegisterResidency(allocation.Get(), resource.Get());
+
+  return SharedDeviceChildHandle<Texture>{
+    new Texture{
+      allocation, std::move(resource), std::move(dsvs), std::move(rtvs), srv, uav, info.desc, info.clear_value
+    },
+    DeviceChildDeleter<Texture>{*this}
+  };
+}
+
+
+auto GraphicsDevice::GetOrCreateRootSignature(std::uint8_t const num_32_bit_params) -> ComPtr<ID3D12RootSignature> {
+  auto root_signature{root_signatures_.Get(num_32_bit_params)};
+
+  if (!root_signature) {
+    std::array<CD3DX12_ROOT_PARAMETER1, 2> root_params;
+    root_params[0].InitAsConstants(num_32_bit_params, 0, 0, D3D12_SHADER_VISIBILITY_ALL);
+    // 2 params: base vertex and base instance. Make sure this aligns with the shader code!
+    root_params[1].InitAsConstants(2, 1, 0, D3D12_SHADER_VISIBILITY_VERTEX);
+
+    D3D12_VERSIONED_ROOT_SIGNATURE_DESC const root_signature_desc{
+      .Version = D3D_ROOT_SIGNATURE_VERSION_1_1,
+      .Desc_1_1 = {
+        static_cast<UINT>(root_params.size()), root_params.data(), 0, nullptr,
+        D3D12_ROOT_SIGNATURE_FLAG_CBV_SRV_UAV_HEAP_DIRECTLY_INDEXED |
+        D3D12_ROOT_SIGNATURE_FLAG_SAMPLER_HEAP_DIRECTLY_INDEXED
+      }
+    };
+
+    ComPtr<ID3DBlob> root_signature_blob;
+    ComPtr<ID3DBlob> error_blob;
+
+    ThrowIfFailed(D3D12SerializeVersionedRootSignature(&root_signature_desc, &root_signature_blob, &error_blob),
+                  "Failed to serialize root signature.");
+    ThrowIfFailed(device_->CreateRootSignature(0, root_signature_blob->GetBufferPointer(),
+                                               root_signature_blob->GetBufferSize(), IID_PPV_ARGS(&root_signature)),
+                  "Failed to create root signature.");
+
+    root_signature = root_signatures_.Add(num_32_bit_params, std::move(root_signature));
+    CreateCommandSignatures(num_32_bit_params, root_signature.Get());
+  }
+
+  return root_signature;
+}
+
+
+auto GraphicsDevice::CompilePipelineState(PipelineDesc const& desc, std::uint8_t const num_32_bit_params,
+                                          ID3D12RootSignature& root_signature) const -> ComPtr<ID3D12PipelineState> {
+  ComPtr<ID3D12PipelineState> pipeline_state;
+
+  CD3DX12_PIPELINE_STATE_STREAM2 pso_desc;
+  pso_desc.Flags = D3D12_PIPELINE_STATE_FLAG_NONE;
+  pso_desc.NodeMask = 0;
+  pso_desc.pRootSignature = &root_signature;
+  pso_desc.PrimitiveTopologyType = desc.primitive_topology_type;
+  pso_desc.VS = desc.vs;
+  pso_desc.GS = desc.gs;
+  pso_desc.StreamOutput = desc.stream_output;
+  pso_desc.HS = desc.hs;
+  pso_desc.DS = desc.ds;
+  pso_desc.PS = desc.ps;
+  pso_desc.AS = desc.as;
+  pso_desc.MS = desc.ms;
+  pso_desc.CS = desc.cs;
+  pso_desc.BlendState = desc.blend_state;
+  pso_desc.DepthStencilState = desc.depth_stencil_state;
+  pso_desc.DSVFormat = desc.ds_format;
+  pso_desc.RasterizerState = desc.rasterizer_state;
+  pso_desc.RTVFormats = desc.rt_formats;
+  pso_desc.SampleDesc = desc.sample_desc;
+  pso_desc.SampleMask = desc.sample_mask;
+  pso_desc.ViewInstancingDesc = desc.view_instancing_desc;
+
+  D3D12_PIPELINE_STATE_STREAM_DESC const stream_desc{sizeof(pso_desc), &pso_desc};
+  std::wstring pipeline_name;
+
+  if (pipeline_library_) {
+    pipeline_name = std::to_wstring(details::HashPipelineDesc(desc, num_32_bit_params));
+    pipeline_state = pipeline_library_->Load(pipeline_name, stream_desc);
+  }
+
+  if (!pipeline_state) {
+    ThrowIfFailed(device_->CreatePipelineState(&stream_desc, IID_PPV_ARGS(&pipeline_state)),
+                  "Failed to create pipeline state.");
+
+    if (pipeline_library_) {
+      pipeline_library_->Store(pipeline_name, *pipeline_state.Get());
+    }
+  }
+
+  return pipeline_state;
+}
+
+
+auto GraphicsDevice::CreateCommandSignatures(std::uint8_t const num_params,
+                                             ID3D12RootSignature* const root_signature) -> void {
+  for (auto const type : {
+         IndirectCommandType::kDraw, IndirectCommandType::kDrawIndexed, IndirectCommandType::kDispatch,
+         IndirectCommandType::kDispatchMesh
+       }) {
+    if (command_signatures_.Get(num_params, type)) {
+      continue;
+    }
+
+    std::vector<D3D12_INDIRECT_ARGUMENT_DESC> arg_descs;
+
+    if (num_params > 0) {
+      arg_descs.emplace_back(D3D12_INDIRECT_ARGUMENT_DESC{
+        .Type = D3D12_INDIRECT_ARGUMENT_TYPE_CONSTANT,
+        .Constant = {.RootParameterIndex = 0, .DestOffsetIn32BitValues = 0, .Num32BitValuesToSet = num_params}
+      });
+    }
+
+    if (type == IndirectCommandType::kDraw || type == IndirectCommandType::kDrawIndexed) {
+      // 2 params: base vertex and base instance. Make sure this aligns with the shader code!
+      arg_descs.emplace_back(D3D12_INDIRECT_ARGUMENT_DESC{
+        .Type = D3D12_INDIRECT_ARGUMENT_TYPE_CONSTANT,
+        .Constant = {.RootParameterIndex = 1, .DestOffsetIn32BitValues = 0, .Num32BitValuesToSet = 2}
+      });
+    }
+
+    switch (type) {
+    case IndirectCommandType::kDraw: {
+      arg_descs.emplace_back(D3D12_INDIRECT_ARGUMENT_DESC{.Type = D3D12_INDIRECT_ARGUMENT_TYPE_DRAW});
+      break;
+    }
+    case IndirectCommandType::kDrawIndexed: {
+      arg_descs.emplace_back(D3D12_INDIRECT_ARGUMENT_DESC{.Type = D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED});
+      break;
+    }
+    case IndirectCommandType::kDispatch: {
+      arg_descs.emplace_back(D3D12_INDIRECT_ARGUMENT_DESC{.Type = D3D12_INDIRECT_ARGUMENT_TYPE_DISPATCH});
+      break;
+    }
+    case IndirectCommandType::kDispatchMesh: {
+      arg_descs.emplace_back(D3D12_INDIRECT_ARGUMENT_DESC{.Type = D3D12_INDIRECT_ARGUMENT_TYPE_DISPATCH_MESH});
+      break;
+    }
+    }
+
+    D3D12_COMMAND_SIGNATURE_DESC const cmd_sig_desc{
+      GetIndirectCommandStride(type, num_params), static_cast<UINT>(arg_descs.size()), arg_descs.data(), 0
+    };
+
+    // The root signature must only be specified if the command signature changes root arguments.
+    ComPtr<ID3D12CommandSignature> cmd_sig;
+    ThrowIfFailed(device_->CreateCommandSignature(&cmd_sig_desc, arg_descs.size() > 1 ? root_signature : nullptr,
+                                                  IID_PPV_ARGS(&cmd_sig)), "Failed to create command signature.");
+
+    command_signatures_.Add(num_params, type, std::move(cmd_sig));
+  }
+}
+
+
+auto GraphicsDevice::PrepareQueueTransfer(ID3D12Resource* const resource, QueueType const queue_type,
+                                          details::QueueTransfer& transfer) -> void {
+  auto const global_state{global_resource_states_.Get(resource)};
+
+  if (!global_state || !global_state->queue || *global_state->queue == queue_type) {
+    return;
+  }
+
+  auto const src_queue_idx{static_cast<std::size_t>(*global_state->queue)};
+  transfer.wait_fence_vals[src_queue_idx] = std::max(transfer.wait_fence_vals[src_queue_idx],
+                                                     global_state->queue_fence_val);
+
+  if (details::IsLayoutSupportedOnQueue(global_state->layout, queue_type)) {
+    return;
+  }
+
+  // The previous queue has to move the texture into a layout every queue supports.
+  transfer.release_barriers[src_queue_idx].emplace_back(D3D12_BARRIER_SYNC_NONE, D3D12_BARRIER_SYNC_NONE,
+                                                        D3D12_BARRIER_ACCESS_NO_ACCESS,
+                                                        D3D12_BARRIER_ACCESS_NO_ACCESS, global_state->layout,
+                                                        D3D12_BARRIER_LAYOUT_COMMON, resource,
+                                                        D3D12_BARRIER_SUBRESOURCE_RANGE{
+                                                          .IndexOrFirstMipLevel = 0xffffffff, .NumMipLevels = 0,
+                                                          .FirstArraySlice = 0, .NumArraySlices = 0,
+                                                          .FirstPlane = 0, .NumPlanes = 0
+                                                        }, D3D12_TEXTURE_BARRIER_FLAG_NONE);
+
+  global_resource_states_.Record(resource, {
+                                   .layout = D3D12_BARRIER_LAYOUT_COMMON, .queue = global_state->queue,
+                                   .queue_fence_val = global_state->queue_fence_val
+                                 });
+}
+
+
+auto GraphicsDevice::ExecuteQueueTransfer(details::QueueTransfer const& transfer, QueueType const queue_type) -> void {
+  auto& dst_queue{GetQueue(queue_type)};
+
+  for (std::size_t i{0}; i < kQueueTypeCount; i++) {
+    auto const src_queue_type{static_cast<QueueType>(i)};
+    auto wait_fence_val{transfer.wait_fence_vals[i]};
+
+    if (!transfer.release_barriers[i].empty()) {
+      D3D12_BARRIER_GROUP const release_barrier_group{
+        .Type = D3D12_BARRIER_TYPE_TEXTURE, .NumBarriers = ClampCast<UINT32>(transfer.release_barriers[i].size()),
+        .pTextureBarriers = transfer.release_barriers[i].data()
+      };
+
+      auto& release_cmd{AcquirePendingBarrierCmdList(src_queue_type)};
+      release_cmd.Begin(nullptr);
+      release_cmd.cmd_list_->Barrier(1, &release_barrier_group);
+      release_cmd.End();
+      queues_[i].pending_cmd_lists.emplace_back(release_cmd.cmd_list_.Get());
+      wait_fence_val = std::max(wait_fence_val, queues_[i].fence->GetNextValue());
+    }
+
+    if (wait_fence_val > dst_queue.waited_fence_vals[i]) {
+      // Queues only ever wait for work that has already been submitted, otherwise they could deadlock.
+      FlushQueue(src_queue_type);
+      FlushQueue(queue_type);
+
+      ThrowIfFailed(dst_queue.queue->Wait(queues_[i].fence->fence_.Get(), wait_fence_val),
+                    "Failed to wait for other GPU queue.");
+      dst_queue.waited_fence_vals[i] = wait_fence_val;
+    }
+  }
+}
+
+
+auto GraphicsDevice::AcquirePendingBarrierCmdList(QueueType const queue_type) -> CommandList& {
+  auto& queue{GetQueue(queue_type)};
+
+  auto const completed_fence_val{queue.fence->GetCompletedValue()};
+  auto const next_fence_val{queue.fence->GetNextValue()};
+
+  for (auto& record : queue.execute_barrier_cmd_lists) {
+    if (record.fence_completion_val <= completed_fence_val) {
+      record.fence_completion_val = next_fence_val;
+      return *record.cmd_list;
+    }
+  }
+
+  return *queue.execute_barrier_cmd_lists.emplace_back(CreateCommandList(queue_type), next_fence_val).cmd_list;
+}
+
+
+auto GraphicsDevice::SignalQueue(QueueType const queue_type) -> UINT64 {
+  auto& queue{GetQueue(queue_type)};
+  return EnqueueSignal(*queue.queue.Get(), *queue.fence);
+}
+
+
+auto GraphicsDevice::FlushQueue(QueueType const queue_type) -> void {
+  auto& queue{GetQueue(queue_type)};
+
+  if (queue.pending_cmd_lists.empty()) {
+    return;
+  }
+
+  queue.queue->ExecuteCommandLists(static_cast<UINT>(queue.pending_cmd_lists.size()),
+                                   queue.pending_cmd_lists.data());
+  queue.pending_cmd_lists.clear();
+  SignalQueue(queue_type);
+}
+
+
+auto GraphicsDevice::UpdateTileMappings(ID3D12Resource& resource,
+                                        std::span<D3D12_TILED_RESOURCE_COORDINATE const> const coordinates,
+                                        std::span<D3D12_TILE_REGION_SIZE const> const sizes, ID3D12Heap* const heap,
+                                        std::span<D3D12_TILE_RANGE_FLAGS const> const range_flags,
+                                        std::span<UINT const> const heap_range_start_offsets,
+                                        std::span<UINT const> const range_tile_counts,
+                                        QueueType const queue_type) -> UINT64 {
+  std::scoped_lock const lock{submit_mutex_};
+
+  // Tiles must not be remapped while other queues still access them.
+  details::QueueTransfer transfer;
+  PrepareQueueTransfer(&resource, queue_type, transfer);
+  ExecuteQueueTransfer(transfer, queue_type);
+
+  // The update is ordered after the work already executed on the queue.
+  FlushQueue(queue_type);
+
+  auto& queue{GetQueue(queue_type)};
+  queue.queue->UpdateTileMappings(&resource, ClampCast<UINT>(coordinates.size()), coordinates.data(), sizes.data(),
+                                  heap, ClampCast<UINT>(range_flags.size()), range_flags.data(),
+                                  heap_range_start_offsets.data(), range_tile_counts.data(),
+                                  D3D12_TILE_MAPPING_FLAG_NONE);
+  auto const fence_val{SignalQueue(queue_type)};
+
+  // Other queues accessing the resource wait for the update.
+  auto const state{global_resource_states_.Get(&resource)};
+  global_resource_states_.Record(&resource, {
+                                   .layout = state ? state->layout : D3D12_BARRIER_LAYOUT_UNDEFINED,
+                                   .queue = queue_type, .queue_fence_val = fence_val
+                                 });
+
+  return fence_val;
+}
+
+
+auto GraphicsDevice::MakeResident(std::span<ID3D12Pageable* const> const pageables,
+                                  QueueType const queue_type) -> void {
+  if (pageables.empty()) {
+    return;
+  }
+
+  // Paging in happens in the background, only the queue waits for it.
+  auto const fence_val{residency_fence_->next_val_++};
+  ThrowIfFailed(device_->EnqueueMakeResident(D3D12_RESIDENCY_FLAG_NONE, ClampCast<UINT>(pageables.size()),
+                                             pageables.data(), residency_fence_->fence_.Get(), fence_val),
+                "Failed to make memory resident.");
+  ThrowIfFailed(GetQueue(queue_type).queue->Wait(residency_fence_->fence_.Get(), fence_val),
+                "Failed to wait for memory to become resident.");
+}
+
+
+auto GraphicsDevice::EvictColdMemory() -> void {
+  auto const threshold{eviction_threshold_.load()};
+
+  if (threshold <= 0) {
+    return;
+  }
+
+  auto const budget{GetMemoryBudget()};
+  auto const limit{static_cast<UINT64>(static_cast<double>(budget.local_budget) * threshold)};
+
+  if (budget.local_usage <= limit) {
+    return;
+  }
+
+  std::array<UINT64, kQueueTypeCount> completed_fence_vals;
+
+  for (std::size_t i{0}; i < kQueueTypeCount; i++) {
+    completed_fence_vals[i] = queues_[i].fence->GetCompletedValue();
+  }
+
+  auto const evicted{residency_manager_->Trim(budget.local_usage - limit, completed_fence_vals)};
+
+  if (!evicted.empty()) {
+    ThrowIfFailed(device_->Evict(ClampCast<UINT>(evicted.size()), evicted.data()), "Failed to evict memory.");
+  }
+}
+
+
+auto GraphicsDevice::EnqueueSignal(ID3D12CommandQueue& queue, Fence& fence) const -> UINT64 {
+  auto const new_fence_val{fence.next_val_.load()};
+  ThrowIfFailed(queue.Signal(fence.fence_.Get(), new_fence_val), "Failed to signal fence from GPU queue.");
+  fence.next_val_ = new_fence_val + 1;
+  return new_fence_val;
+}
+
+
+auto GraphicsDevice::GetQueue(QueueType const queue_type) -> details::CommandQueue& {
+  return queues_[static_cast<std::size_t>(queue_type)];
+}
+
+
+auto GraphicsDevice::GetQueue(QueueType const queue_type) const -> details::CommandQueue const& {
+  return queues_[static_cast<std::size_t>(queue_type)];
+}
+
+
+auto GraphicsDevice::AcquireCopyRecord() -> details::CopyRecord& {
+  auto const completed_fence_val{GetQueue(QueueType::kCopy).fence->GetCompletedValue()};
+
+  for (auto& record : copy_records_) {
+    if (record.fence_completion_val <= completed_fence_val) {
+      record.staging_buffers.clear();
+    }
+  }
+
+  for (auto& record : copy_records_) {
+    if (record.fence_completion_val <= completed_fence_val) {
+      return record;
+    }
   }
+
+  return copy_records_.emplace_back(CreateCommandList(QueueType::kCopy), std::vector<SharedDeviceChildHandle<Buffer>>{},
+                                    0);
 }
 
 
-auto GraphicsDevice::CreateTextureViews(ID3D12Resource2& texture, TextureDesc const& desc, std::vector<UINT>& dsvs,
-                                        std::vector<UINT>& rtvs, std::optional<UINT>& srv,
-                                        std::optional<UINT>& uav) const -> void {
-  DXGI_FORMAT dsv_format;
-  DXGI_FORMAT rtv_srv_uav_format;
+auto GraphicsDevice::AcquireReadbackBuffer(UINT64 const size) -> SharedDeviceChildHandle<Buffer> {
+  auto const bucket_size{std::bit_ceil(std::max<UINT64>(size, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT))};
+  auto& buffers{readback_buffers_[bucket_size]};
 
-  // If a depth format is specified, we have to determine the rtv/srv/uav format.
-  if (desc.format == DXGI_FORMAT_D32_FLOAT_S8X24_UINT) {
-    dsv_format = desc.format;
-    rtv_srv_uav_format = DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS;
-  } else if (desc.format == DXGI_FORMAT_D32_FLOAT) {
-    dsv_format = desc.format;
-    rtv_srv_uav_format = DXGI_FORMAT_R32_FLOAT;
-  } else if (desc.format == DXGI_FORMAT_D24_UNORM_S8_UINT) {
-    dsv_format = desc.format;
-    rtv_srv_uav_format = DXGI_FORMAT_R24_UNORM_X8_TYPELESS;
-  } else if (desc.format == DXGI_FORMAT_D16_UNORM) {
-    dsv_format = desc.format;
-    rtv_srv_uav_format = DXGI_FORMAT_R16_UNORM;
-  } else {
-    dsv_format = desc.format;
-    rtv_srv_uav_format = desc.format;
+  // Buffers only referenced by the pool are not in use by any readback or pending copy.
+  if (auto const it{
+    std::ranges::find_if(buffers, [](SharedDeviceChildHandle<Buffer> const& buffer) {
+      return buffer.use_count() == 1;
+    })
+  }; it != std::end(buffers)) {
+    return *it;
   }
 
-  auto const actual_mip_levels{GetActualMipLevels(desc)};
+  return buffers.emplace_back(CreateBuffer(BufferDesc{bucket_size, 1, false, false, false}, CpuAccess::kRead));
+}
 
-  if (desc.depth_stencil) {
-    dsvs.reserve(actual_mip_levels);
 
-    for (UINT16 i{0}; i < actual_mip_levels; ++i) {
-      D3D12_DEPTH_STENCIL_VIEW_DESC dsv_desc{.Format = dsv_format, .Flags = D3D12_DSV_FLAG_NONE};
+auto GraphicsDevice::SubmitCopyRecord(details::CopyRecord& record,
+                                      std::vector<SharedDeviceChildHandle<Buffer>> staging_buffers) -> UINT64 {
+  record.staging_buffers = std::move(staging_buffers);
+  record.fence_completion_val = ExecuteCommandLists(std::span<CommandList const>{record.cmd_list.get(), 1},
+                                                    QueueType::kCopy);
+  return record.fence_completion_val;
+}
 
-      if (desc.dimension == TextureDimension::k1D) {
-        if (desc.depth_or_array_size == 1) {
-          dsv_desc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE1D;
-          dsv_desc.Texture1D.MipSlice = i;
-        } else {
-          dsv_desc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE1DARRAY;
-          dsv_desc.Texture1DArray.MipSlice = i;
-          dsv_desc.Texture1DArray.FirstArraySlice = 0;
-          dsv_desc.Texture1DArray.ArraySize = desc.depth_or_array_size;
-        }
-      } else if (desc.dimension == TextureDimension::k2D && desc.depth_or_array_size == 1) {
-        if (desc.sample_count == 1) {
-          dsv_desc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D;
-          dsv_desc.Texture2D.MipSlice = i;
-        } else {
-          dsv_desc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2DMS;
-        }
-      } else if ((desc.dimension == TextureDimension::k2D && desc.depth_or_array_size > 1) || desc.dimension ==
-        TextureDimension::kCube) {
-        if (desc.sample_count == 1) {
-          dsv_desc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2DARRAY;
-          dsv_desc.Texture2DArray.MipSlice = i;
-          dsv_desc.Texture2DArray.FirstArraySlice = 0;
-          dsv_desc.Texture2DArray.ArraySize = desc.depth_or_array_size;
-        } else {
-          dsv_desc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2DMSARRAY;
-          dsv_desc.Texture2DMSArray.FirstArraySlice = 0;
-          dsv_desc.Texture2DMSArray.ArraySize = desc.depth_or_array_size;
-        }
-      } else {
-        throw std::runtime_error{"Cannot create depth stencil view for texture."};
-      }
 
-      dsvs.emplace_back(dsv_heap_->Allocate());
-      device_->CreateDepthStencilView(&texture, &dsv_desc, dsv_heap_->GetDescriptorCpuHandle(dsvs.back()));
-    }
+auto GraphicsDevice::AcquireStreamingChunk() -> details::StreamingChunk& {
+  if (streaming_chunks_.empty()) {
+    streaming_chunks_.resize(streaming_chunk_count_);
   }
 
-  if (desc.render_target) {
-    rtvs.reserve(actual_mip_levels);
+  auto& chunk{streaming_chunks_[next_streaming_chunk_idx_]};
+  next_streaming_chunk_idx_ = (next_streaming_chunk_idx_ + 1) % streaming_chunks_.size();
 
-    for (UINT16 i{0}; i < actual_mip_levels; ++i) {
-      D3D12_RENDER_TARGET_VIEW_DESC rtv_desc{.Format = rtv_srv_uav_format};
+  if (!chunk.buffer) {
+    chunk.buffer = CreateBuffer(BufferDesc{streaming_chunk_size_, 1, false, false, false}, CpuAccess::kWrite);
+    return chunk;
+  }
 
-      if (desc.dimension == TextureDimension::k1D) {
-        if (desc.depth_or_array_size == 1) {
-          rtv_desc.ViewDimension = D3D12_RTV_DIMENSION_TEXTURE1D;
-          rtv_desc.Texture1D.MipSlice = i;
-        } else {
-          rtv_desc.ViewDimension = D3D12_RTV_DIMENSION_TEXTURE1DARRAY;
-          rtv_desc.Texture1DArray.MipSlice = i;
-          rtv_desc.Texture1DArray.FirstArraySlice = 0;
-          rtv_desc.Texture1DArray.ArraySize = desc.depth_or_array_size;
-        }
-      } else if (desc.dimension == TextureDimension::k2D && desc.depth_or_array_size == 1) {
-        if (desc.sample_count == 1) {
-          rtv_desc.ViewDimension = D3D12_RTV_DIMENSION_TEXTURE2D;
-          rtv_desc.Texture2D.MipSlice = i;
-          rtv_desc.Texture2D.PlaneSlice = 0;
-        } else {
-          rtv_desc.ViewDimension = D3D12_RTV_DIMENSION_TEXTURE2DMS;
-        }
-      } else if ((desc.dimension == TextureDimension::k2D && desc.depth_or_array_size > 1) || desc.dimension ==
-        TextureDimension::kCube) {
-        if (desc.sample_count == 1) {
-          rtv_desc.ViewDimension = D3D12_RTV_DIMENSION_TEXTURE2DARRAY;
-          rtv_desc.Texture2DArray.MipSlice = i;
-          rtv_desc.Texture2DArray.FirstArraySlice = 0;
-          rtv_desc.Texture2DArray.ArraySize = desc.depth_or_array_size;
-          rtv_desc.Texture2DArray.PlaneSlice = 0;
-        } else {
-          rtv_desc.ViewDimension = D3D12_RTV_DIMENSION_TEXTURE2DMSARRAY;
-          rtv_desc.Texture2DMSArray.FirstArraySlice = 0;
-          rtv_desc.Texture2DMSArray.ArraySize = desc.depth_or_array_size;
-        }
-      } else if (desc.dimension == TextureDimension::k3D) {
-        rtv_desc.ViewDimension = D3D12_RTV_DIMENSION_TEXTURE3D;
-        rtv_desc.Texture3D.MipSlice = i;
-        rtv_desc.Texture3D.FirstWSlice = 0;
-        rtv_desc.Texture3D.WSize = static_cast<UINT>(-1);
-      } else {
-        throw std::runtime_error{"Cannot create render target view for texture."};
-      }
+  WaitSubmission(QueueType::kCopy, chunk.fence_completion_val);
+  return chunk;
+}
+
+
+auto GraphicsDevice::NotifyBudgetCallbacks() -> void {
+  std::vector<BudgetCallback> callbacks;
+  MemoryBudget budget;
+
+  {
+    std::scoped_lock const lock{budget_mutex_};
 
-      rtvs.emplace_back(rtv_heap_->Allocate());
-      device_->CreateRenderTargetView(&texture, &rtv_desc, rtv_heap_->GetDescriptorCpuHandle(rtvs.back()));
+    // Advancing the frame index makes the allocator refresh its cached budget.
+    allocator_->SetCurrentFrameIndex(++frame_idx_);
+
+    if (budget_callbacks_.empty()) {
+      return;
     }
-  }
 
-  if (desc.shader_resource) {
-    D3D12_SHADER_RESOURCE_VIEW_DESC srv_desc{
-      .Format = rtv_srv_uav_format, .Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING
-    };
-    if (desc.dimension == TextureDimension::k1D) {
-      if (desc.depth_or_array_size == 1) {
-        srv_desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE1D;
-        srv_desc.Texture1D.MostDetailedMip = 0;
-        srv_desc.Texture1D.MipLevels = static_cast<UINT>(-1);
-        srv_desc.Texture1D.ResourceMinLODClamp = 0.0f;
-      } else {
-        srv_desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE1DARRAY;
-        srv_desc.Texture1DArray.MostDetailedMip = 0;
-        srv_desc.Texture1DArray.MipLevels = static_cast<UINT>(-1);
-        srv_desc.Texture1DArray.FirstArraySlice = 0;
-        srv_desc.Texture1DArray.ArraySize = desc.depth_or_array_size;
-        srv_desc.Texture1DArray.ResourceMinLODClamp = 0.0f;
-      }
-    } else if (desc.dimension == TextureDimension::k2D) {
-      if (desc.depth_or_array_size == 1) {
-        if (desc.sample_count == 1) {
-          srv_desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-          srv_desc.Texture2D.MostDetailedMip = 0;
-          srv_desc.Texture2D.MipLevels = static_cast<UINT>(-1);
-          srv_desc.Texture2D.PlaneSlice = 0;
-          srv_desc.Texture2D.ResourceMinLODClamp = 0.0f;
-        } else {
-          srv_desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2DMS;
-        }
-      } else {
-        if (desc.sample_count == 1) {
-          srv_desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2DARRAY;
-          srv_desc.Texture2DArray.MostDetailedMip = 0;
-          srv_desc.Texture2DArray.MipLevels = static_cast<UINT>(-1);
-          srv_desc.Texture2DArray.FirstArraySlice = 0;
-          srv_desc.Texture2DArray.ArraySize = desc.depth_or_array_size;
-          srv_desc.Texture2DArray.PlaneSlice = 0;
-          srv_desc.Texture2DArray.ResourceMinLODClamp = 0.0f;
-        } else {
-          srv_desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2DMSARRAY;
-          srv_desc.Texture2DMSArray.FirstArraySlice = 0;
-          srv_desc.Texture2DMSArray.ArraySize = desc.depth_or_array_size;
-        }
+    budget = GetMemoryBudget();
+
+    auto const exceeds{
+      [](UINT64 const usage, UINT64 const limit, float const ratio) {
+        return limit != 0 && static_cast<double>(usage) > static_cast<double>(limit) * ratio;
       }
-    } else if (desc.dimension == TextureDimension::k3D) {
-      srv_desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE3D;
-      srv_desc.Texture3D.MostDetailedMip = 0;
-      srv_desc.Texture3D.MipLevels = static_cast<UINT>(-1);
-      srv_desc.Texture3D.ResourceMinLODClamp = 0.0f;
-    } else if (desc.dimension == TextureDimension::kCube) {
-      if (desc.depth_or_array_size == 6) {
-        srv_desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURECUBE;
-        srv_desc.TextureCube.MostDetailedMip = 0;
-        srv_desc.TextureCube.MipLevels = static_cast<UINT>(-1);
-        srv_desc.TextureCube.ResourceMinLODClamp = 0.0f;
-      } else {
-        srv_desc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURECUBEARRAY;
-        srv_desc.TextureCubeArray.MostDetailedMip = 0;
-        srv_desc.TextureCubeArray.MipLevels = static_cast<UINT>(-1);
-        srv_desc.TextureCubeArray.First2DArrayFace = 0;
-        srv_desc.TextureCubeArray.NumCubes = desc.depth_or_array_size / 6;
-        srv_desc.TextureCubeArray.ResourceMinLODClamp = 0.0f;
+    };
+
+    for (auto const& record : budget_callbacks_) {
+      if (exceeds(budget.local_usage, budget.local_budget, record.usage_ratio) ||
+          exceeds(budget.non_local_usage, budget.non_local_budget, record.usage_ratio)) {
+        callbacks.emplace_back(record.callback);
       }
-    } else {
-      throw std::runtime_error{"Cannot create shader resource view for texture."};
     }
-    srv = res_desc_heap_->Allocate();
-    device_->CreateShaderResourceView(&texture, &srv_desc, res_desc_heap_->GetDescriptorCpuHandle(*srv));
   }
 
-  if (desc.unordered_access) {
-    D3D12_UNORDERED_ACCESS_VIEW_DESC uav_desc{.Format = rtv_srv_uav_format};
-    if (desc.dimension == TextureDimension::k1D) {
-      if (desc.depth_or_array_size == 1) {
-        uav_desc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE1D;
-        uav_desc.Texture1D.MipSlice = 0;
-      } else {
-        uav_desc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE1DARRAY;
-        uav_desc.Texture1DArray.MipSlice = 0;
-        uav_desc.Texture1DArray.FirstArraySlice = 0;
-        uav_desc.Texture1DArray.ArraySize = desc.depth_or_array_size;
-      }
-    } else if (desc.dimension == TextureDimension::k2D && desc.depth_or_array_size == 1) {
-      if (desc.sample_count == 1) {
-        uav_desc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
-        uav_desc.Texture2D.MipSlice = 0;
-        uav_desc.Texture2D.PlaneSlice = 0;
-      } else {
-        uav_desc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2DMS;
-      }
-    } else if ((desc.dimension == TextureDimension::k2D && desc.depth_or_array_size > 1) || desc.dimension ==
-      TextureDimension::k3D) {
-      if (desc.sample_count == 1) {
-        uav_desc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2DARRAY;
-        uav_desc.Texture2DArray.MipSlice = 0;
-        uav_desc.Texture2DArray.FirstArraySlice = 0;
-        uav_desc.Texture2DArray.ArraySize = desc.depth_or_array_size;
-        uav_desc.Texture2DArray.PlaneSlice = 0;
-      } else {
-        uav_desc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2DMSARRAY;
-        uav_desc.Texture2DMSArray.FirstArraySlice = 0;
-        uav_desc.Texture2DMSArray.ArraySize = desc.depth_or_array_size;
-      }
-    } else if (desc.dimension == TextureDimension::k3D) {
-      uav_desc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE3D;
-      uav_desc.Texture3D.MipSlice = 0;
-      uav_desc.Texture3D.FirstWSlice = 0;
-      uav_desc.Texture3D.WSize = static_cast<UINT>(-1);
-    } else {
-      throw std::runtime_error{"Cannot create unordered access view for texture."};
+  // Callbacks may register or unregister callbacks, so they are invoked without holding the lock.
+  for (auto const& callback : callbacks) {
+    callback(budget);
+  }
+}
+
+
+auto GraphicsDevice::RegisterResidency(D3D12MA::Allocation* const allocation,
+                                       ID3D12Resource* const resource) const -> void {
+  if (!allocation) {
+    return;
+  }
+
+  // Only video memory is managed, CPU accessible memory stays resident.
+  if (auto const heap{allocation->GetHeap()}) {
+    if (auto const heap_desc{heap->GetDesc()}; heap_desc.Properties.Type == D3D12_HEAP_TYPE_DEFAULT) {
+      residency_manager_->Register(resource, heap, heap_desc.SizeInBytes);
     }
-    uav = res_desc_heap_->Allocate();
-    device_->CreateUnorderedAccessView(&texture, nullptr, &uav_desc, res_desc_heap_->GetDescriptorCpuHandle(*uav));
+  } else if (D3D12_HEAP_PROPERTIES heap_props; SUCCEEDED(resource->GetHeapProperties(&heap_props, nullptr)) &&
+                                               heap_props.Type == D3D12_HEAP_TYPE_DEFAULT) {
+    // Committed resources are pageable on their own.
+    residency_manager_->Register(resource, resource, allocation->GetSize());
+  }
+}
+
+
+auto GraphicsDevice::UnregisterResidency(ID3D12Resource* const resource) const -> void {
+  if (auto const evicted{residency_manager_->Unregister(resource)}) {
+    MakeResidentOnRelease(*evicted);
   }
 }
 
 
-auto GraphicsDevice::AcquirePendingBarrierCmdList() -> CommandList& {
-  std::unique_lock const lock{execute_barrier_mutex_};
+auto GraphicsDevice::MakeResidentOnRelease(ID3D12Pageable& pageable) const -> void {
+  // Untracked memory must be resident for the resources placed in it later. Called during destruction, so a failure
+  // only leaves the memory evicted.
+  auto const pageable_ptr{&pageable};
+  std::ignore = device_->MakeResident(1, &pageable_ptr);
+}
 
-  auto const completed_fence_val{execute_barrier_fence_->GetCompletedValue()};
-  auto const next_fence_val{execute_barrier_fence_->GetNextValue()};
 
-  for (std::size_t i{0}; i < execute_barrier_cmd_lists_.size(); i++) {
-    if (execute_barrier_cmd_lists_[i].fence_completion_val <= completed_fence_val) {
-      execute_barrier_cmd_lists_[i].fence_completion_val = next_fence_val;
-      return *execute_barrier_cmd_lists_[i].cmd_list;
-    }
+auto GraphicsDevice::TrackMemoryCategory(D3D12MA::Allocation* const allocation, ID3D12Resource* const resource,
+                                         MemoryCategory const category, bool const allocated) const -> void {
+  if (!allocation || allocation->GetResource() != resource) {
+    return;
   }
 
-  return *execute_barrier_cmd_lists_.emplace_back(CreateCommandList(), next_fence_val).cmd_list;
+  auto& counter{memory_categories_[static_cast<std::size_t>(category)]};
+
+  if (allocated) {
+    counter.bytes += allocation->GetSize();
+    ++counter.allocation_count;
+  } else {
+    counter.bytes -= allocation->GetSize();
+    --counter.allocation_count;
+  }
 }
 
 
@@ -1062,4 +3124,23 @@ auto GraphicsDevice::MakeHeapType(CpuAccess const cpu_access) const -> D3D12_HEA
 
   throw std::runtime_error{"Failed to make D3D12 heap type: unknown CPU access type."};
 }
+
+
+auto GraphicsDevice::MakeAllocationDesc(CpuAccess const cpu_access,
+                                        MemoryPool const* const pool) const -> D3D12MA::ALLOCATION_DESC {
+  if (pool && pool->GetDesc().cpu_access != cpu_access) {
+    throw std::runtime_error{"Failed to make allocation description: the CPU access of the memory pool differs."};
+  }
+
+  // Allocations from custom pools take the heap type from the pool.
+  return D3D12MA::ALLOCATION_DESC{
+    MakeAllocationFlags(), pool ? D3D12_HEAP_TYPE_DEFAULT : MakeHeapType(cpu_access), D3D12_HEAP_FLAG_NONE,
+    pool ? pool->pool_.Get() : nullptr, nullptr
+  };
+}
+
+
+auto GraphicsDevice::MakeAllocationFlags() const -> D3D12MA::ALLOCATION_FLAGS {
+  return enforce_budget_ ? D3D12MA::ALLOCATION_FLAG_WITHIN_BUDGET : D3D12MA::ALLOCATION_FLAG_NONE;
+}
 }